@@ -0,0 +1,433 @@
+// bench/car_manager_bench.cpp
+
+#include <benchmark/benchmark.h>
+#include "CarManager.hpp"
+#include "CarStore.hpp"
+#include "Clock.hpp"
+#include "ConcurrentCarManager.hpp"
+#include "car.hpp"
+#include "PriceRangeIndex.hpp"
+#include "RepricingScheduler.hpp"
+#include "SyntheticInventory.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // The same seed gives the same cars, so runs can be compared.
+    constexpr std::uint64_t kSeed = 20240501;
+
+    // Makes count cars with the generator behind gen_inventory; soldFlags (if
+    // given) receives which of them the generator marks as sold.
+    std::vector<CarSpec> GenerateCars(std::size_t count, std::uint64_t seed = kSeed, double soldShare = 0.0,
+                                      std::vector<std::uint8_t> *soldFlags = nullptr)
+    {
+        InventoryOptions options;
+        options.rows = count;
+        options.seed = seed;
+        options.soldRatio = soldShare;
+        SyntheticInventory inventory(options);
+
+        std::vector<CarSpec> cars;
+        cars.reserve(count);
+        if (soldFlags != nullptr)
+        {
+            soldFlags->resize(count);
+        }
+
+        std::vector<std::uint32_t> modelIds(SyntheticInventory::kBlockRows);
+        std::vector<std::uint32_t> years(SyntheticInventory::kBlockRows);
+        std::vector<std::uint64_t> cents(SyntheticInventory::kBlockRows);
+        for (std::uint64_t block = 0; block < inventory.BlockCount(); block++)
+        {
+            inventory.ModelIds(block, modelIds.data());
+            inventory.RegisterYears(block, years.data());
+            inventory.InitialPrices(block, cents.data());
+            if (soldFlags != nullptr)
+            {
+                inventory.SoldFlags(block, soldFlags->data() + block * SyntheticInventory::kBlockRows);
+            }
+
+            for (std::size_t row = 0; row < inventory.BlockRows(block); row++)
+            {
+                cars.push_back({inventory.Models()[modelIds[row]], years[row], cents[row] / 100.0});
+            }
+        }
+        return cars;
+    }
+
+    // Fills a manager with count generated cars and sells about soldShare of them.
+    void Fill(CarManager &manager, std::size_t count, double soldShare = 0.3)
+    {
+        std::vector<std::uint8_t> sold;
+        std::vector<unsigned int> ids = manager.AddCars(GenerateCars(count, kSeed, soldShare, &sold));
+
+        std::vector<unsigned int> toSell;
+        for (std::size_t i = 0; i < ids.size(); i++)
+        {
+            if (sold[i])
+            {
+                toSell.push_back(ids[i]);
+            }
+        }
+        manager.SellCars(toSell);
+    }
+
+    // Every benchmark on the hot paths runs at these inventory sizes.
+    void InventorySizes(benchmark::internal::Benchmark *bench)
+    {
+        bench->Arg(1000)->Arg(100000)->Arg(10000000)->Unit(benchmark::kMicrosecond);
+    }
+
+    // Walks the IDs 1..count in a scattered order, so lookups do not just hit the next cache line.
+    unsigned int NextId(unsigned int id, unsigned int count)
+    {
+        return static_cast<unsigned int>((id + 104729ull) % count) + 1;
+    }
+
+    // Throws everything away; reports are rendered into it so only formatting is measured.
+    class NullBuffer : public std::streambuf
+    {
+
+    protected:
+        int overflow(int c) override { return traits_type::not_eof(c); }
+        std::streamsize xsputn(const char *, std::streamsize count) override { return count; }
+    };
+
+    class NullStream : public std::ostream
+    {
+
+    private:
+        NullBuffer _buffer;
+
+    public:
+        NullStream() : std::ostream(&_buffer){};
+    };
+}
+
+// Adding one car at a time on top of an inventory of state.range(0) cars.
+static void BM_AddCar(benchmark::State &state)
+{
+    CarManager manager;
+    Fill(manager, state.range(0), 0.0);
+    const std::vector<CarSpec> cars = GenerateCars(4096, 7);
+
+    std::size_t next = 0;
+    for (auto _ : state)
+    {
+        const CarSpec &car = cars[next++ & 4095];
+        benchmark::DoNotOptimize(manager.AddCar(car.model, car.registerYear, car.initialPrice));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AddCar)->Apply(InventorySizes);
+
+// One batch of state.range(0) cars, as a dealer feed would deliver it.
+static void BM_AddCars(benchmark::State &state)
+{
+    const std::vector<CarSpec> batch = GenerateCars(state.range(0));
+
+    for (auto _ : state)
+    {
+        CarManager manager;
+        benchmark::DoNotOptimize(manager.AddCars(batch));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AddCars)->Apply(InventorySizes);
+
+// Lookup cost should stay flat while the inventory grows.
+static void BM_IsCarSold(benchmark::State &state)
+{
+    CarManager manager;
+    const auto count = static_cast<unsigned int>(state.range(0));
+    Fill(manager, count);
+
+    unsigned int id = 1;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(manager.IsCarSold(id));
+        id = NextId(id, count);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IsCarSold)->Apply(InventorySizes);
+
+static void BM_SellCar(benchmark::State &state)
+{
+    CarManager manager;
+    const auto count = static_cast<unsigned int>(state.range(0));
+    Fill(manager, count, 0.0);
+
+    unsigned int id = 1;
+    for (auto _ : state)
+    {
+        // Once every car is sold this keeps measuring the lookup + "already sold" path.
+        benchmark::DoNotOptimize(manager.SellCar(id));
+        id = NextId(id, count);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SellCar)->Apply(InventorySizes);
+
+// The same sales with a clock that is read from memory instead of asking the system.
+static void BM_SellCarCoarseClock(benchmark::State &state)
+{
+    CoarseClock clock;
+    CarManager manager(clock);
+    const auto count = static_cast<unsigned int>(state.range(0));
+    Fill(manager, count, 0.0);
+
+    unsigned int id = 1;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(manager.SellCar(id));
+        id = NextId(id, count);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SellCarCoarseClock)->Apply(InventorySizes);
+
+// What one "now" costs with each clock.
+template <typename ClockType>
+static void BM_ClockNow(benchmark::State &state)
+{
+    ClockType clock;
+    const Clock &now = clock;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(now.Now());
+    }
+}
+BENCHMARK_TEMPLATE(BM_ClockNow, SystemClock);
+BENCHMARK_TEMPLATE(BM_ClockNow, CoarseClock);
+BENCHMARK_TEMPLATE(BM_ClockNow, ManualClock);
+
+// Pricing car by car, the way Car::CalculateCurrentPrice does it.
+static void BM_CalculateCurrentPrice(benchmark::State &state)
+{
+    const std::size_t count = state.range(0);
+    const auto now = std::chrono::system_clock::now();
+
+    // Cars added over the last two hours, so they sit at every step of the schedule.
+    std::mt19937_64 random(kSeed);
+    std::uniform_int_distribution<int> age(0, 7200);
+    std::vector<std::chrono::system_clock::time_point> addTimes(count);
+    std::vector<double> initialPrices(count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        addTimes[i] = now - std::chrono::seconds(age(random));
+        initialPrices[i] = 10000.0 + age(random) * 10;
+    }
+
+    for (auto _ : state)
+    {
+        double total = 0.0;
+        for (std::size_t i = 0; i < count; i++)
+        {
+            total += Car::CalculatePrice(initialPrices[i], addTimes[i], now);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_CalculateCurrentPrice)->Apply(InventorySizes);
+
+// The same prices from the batch kernel that the reports use.
+static void BM_CalculatePrices(benchmark::State &state)
+{
+    const std::size_t count = state.range(0);
+    const auto now = std::chrono::system_clock::now();
+
+    std::mt19937_64 random(kSeed);
+    std::uniform_int_distribution<int> age(0, 7200);
+    std::vector<std::chrono::system_clock::rep> addTimes(count);
+    std::vector<double> initialPrices(count);
+    std::vector<double> prices(count);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        addTimes[i] = (now - std::chrono::seconds(age(random))).time_since_epoch().count();
+        initialPrices[i] = 10000.0 + age(random) * 10;
+    }
+
+    for (auto _ : state)
+    {
+        Car::CalculatePrices(addTimes.data(), initialPrices.data(), count, now, prices.data());
+        benchmark::DoNotOptimize(prices.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_CalculatePrices)->Apply(InventorySizes);
+
+// SaveToFile followed by LoadFromFile into a fresh manager.
+static void BM_TextFileRoundTrip(benchmark::State &state)
+{
+    CarManager manager;
+    Fill(manager, state.range(0));
+    const std::string path = "bench_inventory.csv";
+
+    for (auto _ : state)
+    {
+        manager.SaveToFile(path);
+        CarManager loaded;
+        loaded.LoadFromFile(path);
+        benchmark::DoNotOptimize(loaded.GetCarCount());
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TextFileRoundTrip)->Apply(InventorySizes);
+
+// SaveSnapshot followed by LoadSnapshot, the fast restart path.
+static void BM_SnapshotRoundTrip(benchmark::State &state)
+{
+    CarManager manager;
+    Fill(manager, state.range(0));
+    const std::string path = "bench_inventory.snap";
+
+    for (auto _ : state)
+    {
+        manager.SaveSnapshot(path);
+        CarManager loaded;
+        loaded.LoadSnapshot(path);
+        benchmark::DoNotOptimize(loaded.GetCarCount());
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SnapshotRoundTrip)->Apply(InventorySizes);
+
+static void BM_ShowAvailableCars(benchmark::State &state)
+{
+    CarManager manager;
+    Fill(manager, state.range(0));
+    NullStream out;
+
+    for (auto _ : state)
+    {
+        manager.ShowAvailableCars(out);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ShowAvailableCars)->Apply(InventorySizes);
+
+// Moving the cached prices forward one second at a time, with cars added over the last hour.
+static void BM_RepricingAdvance(benchmark::State &state)
+{
+    CarStore store;
+    DepreciationPricer pricer;
+    RepricingScheduler repricing;
+    auto now = std::chrono::system_clock::now();
+
+    std::mt19937_64 random(kSeed);
+    std::uniform_int_distribution<int> age(0, 3600);
+    unsigned int id = 1;
+    for (const CarSpec &car : GenerateCars(state.range(0)))
+    {
+        store.Append(id++, car.model, car.registerYear, car.initialPrice, now - std::chrono::seconds(age(random)));
+    }
+    repricing.AdvanceTo(store, pricer, now);
+
+    std::size_t repriced = 0;
+    for (auto _ : state)
+    {
+        now += std::chrono::seconds(1);
+        repriced += repricing.AdvanceTo(store, pricer, now);
+    }
+    state.counters["repriced"] = benchmark::Counter(static_cast<double>(repriced), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_RepricingAdvance)->Apply(InventorySizes);
+
+// A narrow price range over cars added during the last hour, asked once a second.
+static void BM_FindAvailableByPrice(benchmark::State &state)
+{
+    CarStore store;
+    DepreciationPricer pricer;
+    PriceRangeIndex index;
+    auto now = std::chrono::system_clock::now();
+
+    std::mt19937_64 random(kSeed);
+    std::uniform_int_distribution<int> age(0, 3600);
+    unsigned int id = 1;
+    for (const CarSpec &car : GenerateCars(state.range(0)))
+    {
+        store.Append(id++, car.model, car.registerYear, car.initialPrice, now - std::chrono::seconds(age(random)));
+    }
+    index.Find(store, pricer, 0.0, 0.0, now);
+
+    std::size_t found = 0;
+    for (auto _ : state)
+    {
+        now += std::chrono::seconds(1);
+        found += index.Find(store, pricer, 40000.0, 40100.0, now).size();
+    }
+    state.counters["found"] = benchmark::Counter(static_cast<double>(found), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_FindAvailableByPrice)->Apply(InventorySizes);
+
+// The showroom's "best deals" widget: the ten cheapest cars, over and over.
+static void BM_TopKCheapestAvailable(benchmark::State &state)
+{
+    CarManager manager;
+    Fill(manager, state.range(0));
+    auto now = std::chrono::system_clock::now();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(manager.TopKCheapestAvailable(10, now));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TopKCheapestAvailable)->Apply(InventorySizes);
+
+static void BM_ShowDailyReport(benchmark::State &state)
+{
+    CarManager manager;
+    Fill(manager, state.range(0));
+    NullStream out;
+
+    for (auto _ : state)
+    {
+        manager.ShowDailyReport(out);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ShowDailyReport)->Apply(InventorySizes);
+
+// Sell throughput with several terminals at once; should grow with the thread count.
+static void BM_ConcurrentSellCar(benchmark::State &state)
+{
+    static ConcurrentCarManager *manager = nullptr;
+    const unsigned int count = 1000000;
+
+    if (state.thread_index() == 0)
+    {
+        manager = new ConcurrentCarManager();
+        for (const CarSpec &car : GenerateCars(count))
+        {
+            manager->AddCar(car.model, car.registerYear, car.initialPrice);
+        }
+    }
+
+    // Each thread starts at a different place, so they mostly work on different shards.
+    unsigned int id = 1 + static_cast<unsigned int>(state.thread_index()) * 7919;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(manager->SellCar(id));
+        id = id % count + 1;
+    }
+
+    if (state.thread_index() == 0)
+    {
+        delete manager;
+        manager = nullptr;
+    }
+}
+BENCHMARK(BM_ConcurrentSellCar)->ThreadRange(1, 8)->UseRealTime();
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief One car as read from a line of the inventory file.
+ *
+ * The model name is a view into the text that was parsed, so it is only
+ * valid as long as that text is.
+ */
+struct CarRecord
+{
+    unsigned int id = 0;
+    std::string_view model;
+    unsigned int registerYear = 0;
+    double initialPrice = 0.0;
+    bool isSold = false;
+    double salePrice = 0.0;
+};
+
+/**
+ * @brief Parses one line of the inventory file in place.
+ *
+ * The expected format is `id;model;registerYear;initialPrice;isSold;salePrice`.
+ * Numbers are read with std::from_chars, so nothing is allocated.
+ * The sale price is optional; if it is missing or broken it is left at 0.
+ *
+ * @param line One line of text, without the newline character.
+ * @param record Filled with the parsed values on success.
+ * @return nullptr on success, otherwise a short description of the problem.
+ */
+const char *ParseCarLine(std::string_view line, CarRecord &record);
+
+/**
+ * @brief A line that could not be parsed.
+ */
+struct CarCsvError
+{
+    std::size_t lineNumber; ///< Line number inside the parsed chunk, starting at 1.
+    std::string_view line;
+    const char *message;
+};
+
+/**
+ * @brief The result of parsing one piece of the inventory file.
+ */
+struct CarCsvChunk
+{
+    std::vector<CarRecord> records;
+    std::vector<CarCsvError> errors;
+    std::size_t lineCount = 0;
+};
+
+/**
+ * @brief Parses every line of the given text.
+ *
+ * @param text Whole lines of the inventory file.
+ * @param chunk Receives the parsed records, the broken lines and the line count.
+ */
+void ParseCarChunk(std::string_view text, CarCsvChunk &chunk);
+
+/**
+ * @brief Parses a whole inventory file, using several threads for big files.
+ *
+ * The text is cut into pieces at line boundaries and every piece is parsed
+ * on its own thread. The pieces are returned in file order, so joining them
+ * gives exactly the same records as parsing the text in one go.
+ * Small inputs are parsed on the calling thread.
+ *
+ * @param text The whole inventory file.
+ * @param threadCount How many threads to use at most; 0 means one per CPU core.
+ * @param minBytesPerThread Smallest piece worth giving its own thread.
+ * @return The parsed pieces, in file order.
+ */
+std::vector<CarCsvChunk> ParseCarCsv(std::string_view text, unsigned int threadCount = 0,
+                                     std::size_t minBytesPerThread = 1 << 20);
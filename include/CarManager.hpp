@@ -1,55 +1,165 @@
 #pragma once
 
 #include "car.hpp"
-#include <vector>
+#include "CarStore.hpp"
+#include "Clock.hpp"
+#include "Depreciation.hpp"
+#include "IdIndex.hpp"
+#include "InventoryEvents.hpp"
+#include "Journal.hpp"
+#include "ModelIndex.hpp"
+#include "PriceRangeIndex.hpp"
+#include "PriceSelection.hpp"
+#include "ReportBuffer.hpp"
+#include "RepricingScheduler.hpp"
+#include <chrono>
+#include <cstddef>
 #include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
 
 
+/**
+ * @brief Summary numbers of the inventory, see CarManager::GetStatistics().
+ */
+struct InventoryStatistics
+{
+    std::size_t soldCount = 0;
+    std::size_t availableCount = 0;
+    double totalRevenue = 0.0;     ///< Sum of the sale prices of all sold cars.
+    double totalListedValue = 0.0; ///< Sum of the initial prices of all cars still for sale.
+    double totalDiscount = 0.0;    ///< Initial minus sale price, summed over all sold cars.
+};
+
+/**
+ * @brief The details of one car to add with CarManager::AddCars.
+ */
+struct CarSpec
+{
+    std::string model;
+    unsigned int registerYear = 0;
+    double initialPrice = 0.0;
+};
+
+/**
+ * @brief One car of a price list, see CarManager::TopKCheapestAvailable().
+ */
+struct PricedCar
+{
+    unsigned int id = 0;
+    double price = 0.0;
+};
+
 /**
  * @brief Manages the collection of cars available in the dealership.
  *
  * This class handles adding new cars, selling existing ones, showing lists
  * of cars, and generating reports. It keeps all the car data organized.
+ *
+ * Cars are kept in a column-oriented CarStore, so there is no separate heap
+ * allocation per car and scans over the inventory read memory in order.
  */
 class CarManager
 {
 
 private:
-    std::vector<std::unique_ptr<Car>> _cars;
+    CarStore _store;
+    IdIndex _idIndex;
+    ModelIndex _modelIndex;
     unsigned int _nextCarId;
 
+    std::unique_ptr<Journal> _journal;
+    std::string _snapshotFilename;
+    std::size_t _compactAfter;
+
+    DepreciationPricer _depreciation;
+    InventoryEventSink *_events;
+    const Clock *_clock;
+
+    mutable RepricingScheduler _repricing; // cached prices of the available cars, moved forward on reads
+    mutable PriceRangeIndex _priceIndex;   // available cars by add second and initial price
+    mutable ReportBuffer _report;          // reused by every report
+    mutable ReportBuffer _reportAvailable; // second half of the report while it is built
+
+    void ApplyJournalRecord(const JournalRecord &record);
+    void CompactIfNeeded();
+    std::size_t TrySell(std::chrono::system_clock::time_point currentTime, SaleResult &result); // slot of result.id, or npos
+
 public:
 
-    CarManager() : _nextCarId(1){};
+    CarManager() : CarManager(DefaultClock()){};
+
+    /**
+     * @brief Creates an empty inventory that takes the current time from the given clock.
+     *
+     * Add times, sale prices and the prices in reports all use this clock,
+     * so a ManualClock can fast-forward depreciation, and a CoarseClock
+     * saves a system call on every sale. The clock must outlive the manager.
+     */
+    explicit CarManager(const Clock &clock)
+        : _nextCarId(1), _compactAfter(100000), _depreciation(kDefaultDepreciation), _events(&NullEventSink()), _clock(&clock){};
 
     /**
      * @brief Adds a new car to the inventory.
      *
-     * Creates a new Car object with a unique ID, based on the provided details,
-     * and adds it to the manager's list. The car is initially not sold.
+     * Stores a new car with a unique ID, based on the provided details,
+     * as a new row of the inventory. The car is initially not sold.
+     * The event sink is told about the new car.
      *
      * @param model The car's model, like "Opel Astra".
      * @param registerYear The year the car was first registered.
      * @param initialPrice The price the car is listed at when added.
+     * @return The ID given to the new car.
      */
-    void AddCar(const std::string& model, unsigned int registerYear, double initialPrice);
+    unsigned int AddCar(const std::string& model, unsigned int registerYear, double initialPrice);
 
     /**
      * @brief Attempts to sell a car by its unique ID.
      *
-     * Finds the car with the matching ID. If found and not already sold,
+     * Finds the car with the matching ID through the ID index. If found and not already sold,
      * it marks the car as sold, calculates its final sale price based on current time,
-     * and records that price. Prints messages about success or failure.
+     * and records that price. The outcome is passed to the event sink.
      *
      * @param id The unique ID of the car to sell.
      * @return true if a car with the given ID was found and successfully marked as sold, false otherwise
      */
     bool SellCar(unsigned int id);
 
+    /**
+     * @brief Same as SellCar, but tells exactly how the sale ended and for what price.
+     */
+    SaleResult Sell(unsigned int id);
+
+    /**
+     * @brief Adds many cars at once.
+     *
+     * Does the bookkeeping once per batch instead of once per car: room for
+     * all cars is reserved up front, all of them share one add time, and
+     * they are journaled with a single write.
+     *
+     * @param cars The cars to add, in order.
+     * @return The ID given to each car, in the same order.
+     */
+    std::vector<unsigned int> AddCars(const std::vector<CarSpec>& cars);
+
+    /**
+     * @brief Sells many cars at once.
+     *
+     * Every car is priced at the same moment, and all sales are journaled
+     * with a single write. The result of each sale is returned (and passed
+     * to the event sink). If an ID appears twice, the second one is AlreadySold.
+     *
+     * @param ids The IDs of the cars to sell.
+     * @return One result per ID, in the same order.
+     */
+    std::vector<SaleResult> SellCars(const std::vector<unsigned int>& ids);
+
     /**
      * @brief Checks if a specific car is currently marked as sold.
      *
-     * Searches for a car with the given ID and returns its sold status.
+     * Looks up the car with the given ID in the ID index (constant time)
+     * and returns its sold status.
      *
      * @param id The unique ID of the car to check.
      * @return true if a car with the given ID exists in the inventory and is marked as sold, false otherwise.
@@ -62,6 +172,24 @@ public:
      */
     int GetCarCount() const;
 
+    /**
+     * @brief Gets the number of cars still for sale, without looking at single cars.
+     */
+    std::size_t GetAvailableCount() const;
+
+    /**
+     * @brief Gets the number of sold cars, without looking at single cars.
+     */
+    std::size_t GetSoldCount() const;
+
+    /**
+     * @brief Gets the summary numbers of the inventory.
+     *
+     * The numbers are kept up to date by every add, sale and load, so
+     * asking for them costs the same for any inventory size.
+     */
+    InventoryStatistics GetStatistics() const;
+
      /**
      * @brief Gets the next available unique ID that will be assigned to a newly added car.
      *
@@ -76,8 +204,14 @@ public:
      * @brief Loads car data from a specified file.
      *
      * Cleans the current list of cars and attempts to read car details
-     * from the file, adding them to the inventory.
-     * Handles cases where the file doesn't exist or has errors.
+     * from the file, adding them to the inventory. If a journal is open,
+     * it is compacted afterwards, as the old changes no longer apply.
+     * The file is mapped into memory and parsed in place, so each model
+     * name is copied only once, straight into the inventory. Big files
+     * are parsed in pieces on several threads and joined in file order.
+     * If the file cannot be opened, a warning goes to the event sink and
+     * the inventory (and the journal) are left unchanged. Broken lines are
+     * reported to the event sink with their line number and skipped.
      *
      * @param filename The path to the file to load data from.
      */
@@ -94,14 +228,168 @@ public:
      */
     void SaveToFile(const std::string& filename) const;
 
+    /**
+     * @brief Saves the whole inventory as a binary snapshot.
+     *
+     * The snapshot stores every column of the inventory as one block
+     * (see Snapshot.hpp), together with a checksum, so it can be loaded
+     * back without any text parsing. Unlike the text file, it also keeps
+     * the time each car was added, so depreciation continues after a restart.
+     * The file is written under a temporary name first and then renamed,
+     * so an existing snapshot is only replaced by a complete one. The file
+     * is synced to disk before the rename and its directory after it, so a
+     * snapshot reported as written survives a power loss.
+     *
+     * @param filename The path to the snapshot file.
+     * @return true if the snapshot was written and synced, false otherwise.
+     */
+    bool SaveSnapshot(const std::string& filename) const;
+
+    /**
+     * @brief Loads the inventory from a binary snapshot.
+     *
+     * The file is mapped into memory and its columns are copied straight
+     * into the inventory. The current inventory is only replaced if the
+     * snapshot is complete, has the right version and its checksum matches.
+     *
+     * @param filename The path to the snapshot file.
+     * @return true if the snapshot was loaded, false if it is missing or invalid.
+     */
+    bool LoadSnapshot(const std::string& filename);
+
+    /**
+     * @brief Restores the inventory from a snapshot plus its journal and starts journaling.
+     *
+     * Loads the snapshot (if there is one), replays every change recorded
+     * in the journal since that snapshot, and then keeps the journal open:
+     * from now on every AddCar and SellCar is appended to it, so saving costs
+     * only as much as the changes made. Replaying is safe to repeat; cars that
+     * are already present or already sold are left alone.
+     *
+     * @param snapshotFilename The path to the snapshot file used for compaction.
+     * @param journalFilename The path to the journal file.
+     * @return true if anything was restored (snapshot or journal records), false if both were empty or missing.
+     */
+    bool OpenJournal(const std::string& snapshotFilename, const std::string& journalFilename);
+
+    /**
+     * @brief Folds the journal into a fresh snapshot and empties the journal.
+     *
+     * Called automatically once the journal grows past the compaction
+     * threshold and after LoadFromFile. Does nothing when no journal is open.
+     * If the journal cannot be synced first, nothing is snapshotted or dropped.
+     */
+    void CompactJournal();
+
+    /**
+     * @brief Makes sure every journaled change is on disk (fsync).
+     *
+     * @return true if the journal is synced (or there is none), false if the sync failed.
+     */
+    bool SyncJournal();
+
+    /**
+     * @brief Sets after how many journal records the journal is compacted automatically.
+     */
+    void SetJournalCompactionThreshold(std::size_t records) { _compactAfter = records; }
+
+    /**
+     * @brief Sets where the manager reports what it does (adds, sales, file messages).
+     *
+     * The manager does not own the sink; it has to live as long as the
+     * manager uses it. nullptr switches back to the default sink, which
+     * ignores everything, so by default the manager prints nothing.
+     */
+    void SetEventSink(InventoryEventSink *sink) { _events = sink != nullptr ? sink : &NullEventSink(); }
+
+    const Clock &GetClock() const { return *_clock; }
+
+    /**
+     * @brief Sets the pricing rule used for sales and price lists.
+     *
+     * The multiplier table for the rule is built here, once, so sales and
+     * price lists only look prices up. Defaults to kDefaultDepreciation.
+     */
+    void SetDepreciationSchedule(const DepreciationSchedule &schedule)
+    {
+        _depreciation = DepreciationPricer(schedule);
+        _repricing.Invalidate();
+        _priceIndex.Invalidate();
+    }
+    const DepreciationSchedule &GetDepreciationSchedule() const { return _depreciation.Schedule(); }
+
     /**
      * @brief Displays basic information for all cars currently available for sale.
      *
      * Iterates through the inventory and calls ShowCarInfo for any car
      * that is not marked as sold. Includes calculated price with depreciation.
+     * Prices come from the repricing scheduler, so only the cars whose
+     * price stepped since the last list are priced again.
      */
     void ShowAvailableCars() const;
 
+    /**
+     * @brief Same as ShowAvailableCars(), written to the given stream.
+     *
+     * The list is formatted into a buffer first and then written to the
+     * stream in a single call, like ShowDailyReport(out).
+     */
+    void ShowAvailableCars(std::ostream& out) const;
+
+    /**
+     * @brief Finds the available cars whose model name starts with the given text.
+     *
+     * Served from the model index, so only the matching models are looked
+     * at, not the whole inventory. The search is case sensitive.
+     *
+     * @param modelPrefix The start of the model name, like "Opel" or "Mercedes-Benz C".
+     * @return The IDs of the matching cars, in inventory order.
+     */
+    std::vector<unsigned int> FindAvailableByModel(const std::string& modelPrefix) const;
+
+    /**
+     * @brief Finds the available cars whose current price lies in the given range.
+     *
+     * Served from the price range index, so the cost grows with the number
+     * of matches and the length of the pricing schedule, not with the size
+     * of the inventory. Prices are taken at the clock's current time.
+     *
+     * @param minPrice The lowest price to include.
+     * @param maxPrice The highest price to include.
+     * @return The IDs of the matching cars, in inventory order.
+     */
+    std::vector<unsigned int> FindAvailableByPrice(double minPrice, double maxPrice) const;
+
+    /**
+     * @brief Gets the k cheapest available cars at the given time, cheapest first.
+     *
+     * Only the best k cars are kept while the inventory is priced, and big
+     * inventories are split across threads, so the inventory is never
+     * copied or sorted. Cars with the same price come in inventory order.
+     *
+     * @param k How many cars to return at most.
+     * @param currentTime The time the prices are taken at.
+     * @return Up to k cars with their current price.
+     */
+    std::vector<PricedCar> TopKCheapestAvailable(std::size_t k, std::chrono::system_clock::time_point currentTime) const;
+
+    /**
+     * @brief Same as TopKCheapestAvailable, for the most expensive available cars, most expensive first.
+     */
+    std::vector<PricedCar> TopKMostExpensive(std::size_t k, std::chrono::system_clock::time_point currentTime) const;
+
+    /**
+     * @brief Displays the available cars whose model name starts with the given text.
+     *
+     * Same output as ShowAvailableCars, limited to the matching cars.
+     */
+    void ShowAvailableCarsByModel(const std::string& modelPrefix) const;
+
+    /**
+     * @brief Same as ShowAvailableCarsByModel(modelPrefix), written to the given stream.
+     */
+    void ShowAvailableCarsByModel(std::ostream& out, const std::string& modelPrefix) const;
+
     /**
      * @brief Prints a report showing the status of all cars.
      *
@@ -110,4 +398,13 @@ public:
      * Includes sale price for sold cars and current price for available ones.
      */
     void ShowDailyReport() const;
+
+    /**
+     * @brief Same as ShowDailyReport(), written to the given stream.
+     *
+     * The inventory is walked once, sorting each car into the sold or the
+     * available part, and the whole report is formatted into a buffer first
+     * and then written to the stream in a single call.
+     */
+    void ShowDailyReport(std::ostream& out) const;
 };
\ No newline at end of file
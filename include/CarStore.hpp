@@ -0,0 +1,281 @@
+#pragma once
+
+#include "ModelDictionary.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class CarStore;
+
+/// Index of the lowest set bit of a non-zero word.
+inline unsigned int LowestSetBit(std::uint64_t word)
+{
+#if defined(__GNUC__)
+    return static_cast<unsigned int>(__builtin_ctzll(word));
+#else
+    unsigned int bit = 0;
+    while ((word & 1) == 0)
+    {
+        word >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+/// Number of set bits in a word.
+inline unsigned int CountSetBits(std::uint64_t word)
+{
+#if defined(__GNUC__)
+    return static_cast<unsigned int>(__builtin_popcountll(word));
+#else
+    unsigned int count = 0;
+    for (; word != 0; word &= word - 1)
+    {
+        count++;
+    }
+    return count;
+#endif
+}
+
+/**
+ * @brief Raw pointers to whole columns of cars, used to fill a CarStore in bulk.
+ *
+ * Every array holds `count` values. The model names are a dictionary of
+ * `modelCount` names: modelStarts holds `modelCount + 1` offsets into
+ * modelPool, and modelIds gives each car its index in that dictionary.
+ */
+struct CarColumns
+{
+    std::size_t count = 0;
+    const std::uint32_t *ids = nullptr;
+    const std::uint32_t *registerYears = nullptr;
+    const double *initialPrices = nullptr;
+    const std::int64_t *addTimes = nullptr;
+    const std::uint8_t *soldFlags = nullptr;
+    const double *salePrices = nullptr;
+    const std::uint32_t *modelIds = nullptr;
+    std::size_t modelCount = 0;
+    const std::uint64_t *modelStarts = nullptr;
+    const char *modelPool = nullptr;
+    std::size_t modelPoolSize = 0;
+};
+
+/**
+ * @brief A lightweight, read-only view of one car stored in a CarStore.
+ *
+ * It only remembers which store and which row it points to, so it is cheap
+ * to copy around. It offers the same getters as Car, but reads every value
+ * straight from the store's columns.
+ * A view is only valid until the store is changed.
+ */
+class CarView
+{
+
+private:
+    const CarStore *_store;
+    std::size_t _slot;
+
+public:
+    CarView(const CarStore &store, std::size_t slot) : _store(&store), _slot(slot){};
+
+    // Getters
+    std::size_t GetSlot() const { return _slot; }
+    unsigned int GetId() const;
+    std::string_view GetModel() const;
+    unsigned int GetRegisterYear() const;
+    double GetInitialPrice() const;
+    double GetSalePrice() const;
+    std::chrono::system_clock::time_point GetAddTime() const;
+    bool IsSold() const;
+
+    /**
+     * @brief Calculates the current price of the car considering depreciation.
+     *
+     * Uses exactly the same rules as Car::CalculateCurrentPrice.
+     *
+     * @param currentTime The current system time point used to calculate elapsed time since added.
+     * @return The current calculated price of the car.
+     */
+    double CalculateCurrentPrice(std::chrono::system_clock::time_point currentTime) const;
+
+    /**
+     * @brief Displays detailed information about the car to the console.
+     *
+     * Includes ID, model, year, initial price, current price, and sale status.
+     */
+    void ShowCarInfo(std::chrono::system_clock::time_point currentTime) const;
+
+    /**
+     * @brief Same as ShowCarInfo(currentTime), for a current price that was already calculated.
+     */
+    void ShowCarInfoWithPrice(double currentPrice) const;
+
+    /**
+     * @brief Displays detailed information about the car to the console.
+     *
+     * Includes ID, model, year, initial price and sale status.
+     */
+    void ShowCarInfo() const;
+};
+
+/**
+ * @brief Column-oriented (struct-of-arrays) storage for the car inventory.
+ *
+ * Every car field is kept in its own contiguous array. Model names are
+ * interned: every distinct name is stored once in a ModelDictionary and a
+ * car only keeps its 32-bit model ID. A car is just a row number
+ * ("slot") in these arrays. Scanning one field over the whole inventory
+ * (like the sold flags or the prices) therefore reads memory in order,
+ * with no pointer chasing and no heap allocation per car.
+ *
+ * The sold status is a bitmap, one bit per car. Walking the sold or the
+ * available cars looks at 64 cars per step and jumps straight to the next
+ * matching one, so a lot where almost everything is sold costs almost
+ * nothing to list.
+ */
+class CarStore
+{
+
+private:
+    std::vector<unsigned int> _ids;
+    std::vector<unsigned int> _registerYears;
+    std::vector<double> _initialPrices;
+    std::vector<std::chrono::system_clock::rep> _addTimes;
+    std::vector<std::uint64_t> _soldBits; // bit (slot % 64) of word (slot / 64)
+    std::size_t _soldCount;
+    std::vector<double> _salePrices;
+
+    // Running sums, kept up to date by Append, MarkSold and Assign
+    double _availableInitialValue; // initial prices of cars still for sale
+    double _soldInitialValue;      // initial prices of sold cars
+    double _revenue;               // sale prices of sold cars
+
+    ModelDictionary _dictionary;          // every distinct model name, once
+    std::vector<std::uint32_t> _modelIds; // per row, an ID in _dictionary
+
+public:
+    CarStore() : _soldCount(0), _availableInitialValue(0.0), _soldInitialValue(0.0), _revenue(0.0){};
+
+    /**
+     * @brief Adds a new, not sold car as the last row.
+     *
+     * @param id A unique number so we know which car is which.
+     * @param model The car's model name; it is added to the dictionary if it is new.
+     * @param registerYear The year it was first registered.
+     * @param initialPrice The price we first listed the car at.
+     * @param addTime The moment the car was added to the system.
+     * @return The slot of the new row.
+     */
+    std::size_t Append(unsigned int id, std::string_view model, unsigned int registerYear,
+                       double initialPrice, std::chrono::system_clock::time_point addTime);
+
+    /**
+     * @brief Marks the car in the given slot as sold for the given price.
+     *
+     * Marking a sold car again only updates its sale price.
+     */
+    void MarkSold(std::size_t slot, double salePrice);
+
+    /**
+     * @brief Makes room for the given number of cars up front.
+     *
+     * Model names need no room: there are only a few thousand distinct ones.
+     *
+     * @param carCount The number of cars the store should hold without growing.
+     */
+    void Reserve(std::size_t carCount);
+
+    /**
+     * @brief Removes all cars from the store.
+     *
+     * The model dictionary is emptied too, so model IDs start again at 0.
+     */
+    void Clear();
+
+    /**
+     * @brief Replaces the whole store with the given columns.
+     *
+     * Every column is copied in one block, without looking at single cars.
+     */
+    void Assign(const CarColumns &columns);
+
+    std::size_t Size() const { return _ids.size(); }
+    bool Empty() const { return _ids.empty(); }
+
+    /**
+     * @brief Gets a view of the car in the given slot.
+     */
+    CarView operator[](std::size_t slot) const { return CarView(*this, slot); }
+
+    // Per-row getters
+    unsigned int GetId(std::size_t slot) const { return _ids[slot]; }
+    std::string_view GetModel(std::size_t slot) const { return _dictionary.Name(_modelIds[slot]); }
+    std::uint32_t GetModelId(std::size_t slot) const { return _modelIds[slot]; }
+    unsigned int GetRegisterYear(std::size_t slot) const { return _registerYears[slot]; }
+    double GetInitialPrice(std::size_t slot) const { return _initialPrices[slot]; }
+    double GetSalePrice(std::size_t slot) const { return _salePrices[slot]; }
+    std::chrono::system_clock::time_point GetAddTime(std::size_t slot) const
+    {
+        return std::chrono::system_clock::time_point(std::chrono::system_clock::duration(_addTimes[slot]));
+    }
+    bool IsSold(std::size_t slot) const { return (_soldBits[slot / 64] >> (slot % 64)) & 1; }
+
+    std::size_t SoldCount() const { return _soldCount; }
+    std::size_t AvailableCount() const { return _ids.size() - _soldCount; }
+
+    // Sums over the whole inventory, without looking at single cars
+    double AvailableInitialValue() const { return _availableInitialValue; }
+    double SoldInitialValue() const { return _soldInitialValue; }
+    double Revenue() const { return _revenue; }
+
+    /**
+     * @brief Calls visit(slot) for every sold car, in slot order.
+     */
+    template <typename Visitor>
+    void ForEachSold(Visitor visit) const
+    {
+        for (std::size_t word = 0; word < _soldBits.size(); word++)
+        {
+            for (std::uint64_t bits = _soldBits[word]; bits != 0; bits &= bits - 1)
+            {
+                visit(word * 64 + LowestSetBit(bits));
+            }
+        }
+    }
+
+    /**
+     * @brief Calls visit(slot) for every car that is not sold, in slot order.
+     */
+    template <typename Visitor>
+    void ForEachAvailable(Visitor visit) const
+    {
+        const std::size_t count = _ids.size();
+        for (std::size_t word = 0; word < _soldBits.size(); word++)
+        {
+            std::uint64_t bits = ~_soldBits[word];
+            if (word == count / 64)
+            {
+                bits &= (std::uint64_t(1) << (count % 64)) - 1; // no cars past the end
+            }
+
+            for (; bits != 0; bits &= bits - 1)
+            {
+                visit(word * 64 + LowestSetBit(bits));
+            }
+        }
+    }
+
+    // Whole columns, for scans over the inventory
+    const std::vector<unsigned int> &Ids() const { return _ids; }
+    const std::vector<unsigned int> &RegisterYears() const { return _registerYears; }
+    const std::vector<double> &InitialPrices() const { return _initialPrices; }
+    const std::vector<std::chrono::system_clock::rep> &AddTimes() const { return _addTimes; }
+    const std::vector<std::uint64_t> &SoldBits() const { return _soldBits; }
+    const std::vector<double> &SalePrices() const { return _salePrices; }
+    const std::vector<std::uint32_t> &ModelIds() const { return _modelIds; }
+    const ModelDictionary &Models() const { return _dictionary; }
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+/**
+ * @brief Where the inventory gets the current time from.
+ *
+ * Cars remember when they were added and are priced by how long ago that
+ * was, so everything that asks for "now" goes through a Clock. Swapping the
+ * clock lets tests and what-if pricing runs jump hours ahead instantly, and
+ * lets busy servers read a cached time instead of asking the system.
+ */
+class Clock
+{
+
+public:
+    virtual ~Clock() = default;
+
+    virtual std::chrono::system_clock::time_point Now() const = 0;
+};
+
+/**
+ * @brief The real time, straight from std::chrono::system_clock.
+ */
+class SystemClock : public Clock
+{
+
+public:
+    std::chrono::system_clock::time_point Now() const override { return std::chrono::system_clock::now(); }
+};
+
+/**
+ * @brief The shared system clock, used when no other clock is given.
+ */
+inline const Clock &DefaultClock()
+{
+    static SystemClock clock;
+    return clock;
+}
+
+/**
+ * @brief A clock that only moves when told to.
+ *
+ * Useful for tests and simulations: Advance(std::chrono::hours(1)) makes an
+ * hour of depreciation happen at once. Safe to read and move from several threads.
+ */
+class ManualClock : public Clock
+{
+
+private:
+    std::atomic<std::chrono::system_clock::rep> _now;
+
+public:
+    explicit ManualClock(std::chrono::system_clock::time_point start = std::chrono::system_clock::now())
+        : _now(start.time_since_epoch().count()){};
+
+    std::chrono::system_clock::time_point Now() const override
+    {
+        return std::chrono::system_clock::time_point(std::chrono::system_clock::duration(_now.load(std::memory_order_relaxed)));
+    }
+
+    void Set(std::chrono::system_clock::time_point now) { _now.store(now.time_since_epoch().count(), std::memory_order_relaxed); }
+
+    void Advance(std::chrono::system_clock::duration step) { _now.fetch_add(step.count(), std::memory_order_relaxed); }
+};
+
+/**
+ * @brief The system time, refreshed in the background at a fixed interval.
+ *
+ * A helper thread reads the system clock once per interval (1 ms by
+ * default) and Now() just returns the last value it read, so hot paths
+ * like selling pay for one atomic load instead of a system clock call.
+ * The time it returns is up to one interval old; prices only change every
+ * few seconds, so that makes no difference.
+ */
+class CoarseClock : public Clock
+{
+
+private:
+    std::atomic<std::chrono::system_clock::rep> _now;
+    std::atomic<bool> _stop;
+    std::chrono::system_clock::duration _interval;
+    std::thread _ticker;
+
+    void Tick();
+
+public:
+    explicit CoarseClock(std::chrono::system_clock::duration interval = std::chrono::milliseconds(1));
+    ~CoarseClock() override;
+
+    CoarseClock(const CoarseClock &) = delete;
+    CoarseClock &operator=(const CoarseClock &) = delete;
+
+    std::chrono::system_clock::time_point Now() const override
+    {
+        return std::chrono::system_clock::time_point(std::chrono::system_clock::duration(_now.load(std::memory_order_relaxed)));
+    }
+};
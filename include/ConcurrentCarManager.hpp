@@ -0,0 +1,263 @@
+#pragma once
+
+#include "Clock.hpp"
+#include "Depreciation.hpp"
+#include "ReportBuffer.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class InventoryView;
+
+/**
+ * @brief A car inventory that many sales terminals can use at the same time.
+ *
+ * Cars are spread over a number of shards by their ID (consecutive IDs land
+ * in different shards), and every shard has its own lock. Within its shard
+ * a car sits at a slot computed from its ID, so shards are ordered by ID
+ * and need no lookup table. Adding a car only locks the one shard it goes
+ * to. Selling a car takes no lock at all: the sold flag is switched with an
+ * atomic compare-and-swap, so when two terminals try to sell the same car
+ * exactly one of them wins.
+ *
+ * Every add and sale also gets a version number. Reports read the inventory
+ * through an InventoryView (see GetView()), which shows the inventory as it
+ * was at one version: no locks are taken, sellers never wait for a report,
+ * and a report never sees half of a change. Writers never wait for each
+ * other either: a view only waits, car by car, for the few changes that
+ * had their version handed out but were not finished when it looked.
+ *
+ * Unlike CarManager this class prints nothing; callers decide what to show.
+ */
+class ConcurrentCarManager
+{
+
+private:
+    friend class InventoryView;
+
+    enum SaleState : unsigned char
+    {
+        Available = 0,
+        Claimed = 1, ///< a seller won the car and is recording the price
+        Sold = 2,
+    };
+
+    static constexpr std::uint64_t kNotSold = ~std::uint64_t(0);
+    static constexpr std::uint64_t kNoAdd = 0;                      // Shard::addingVersion: no add running
+    static constexpr std::uint64_t kVersionPending = ~std::uint64_t(0); // an add is running, version not known yet
+
+    struct Entry
+    {
+        // Written once before the entry is published, read-only afterwards
+        unsigned int id = 0;
+        std::string model;
+        unsigned int registerYear = 0;
+        double initialPrice = 0.0;
+        std::chrono::system_clock::time_point addTime;
+        std::atomic<std::uint64_t> addedVersion{0}; // 0 while the slot is empty; stored last
+
+        // Changed by the winning seller
+        std::atomic<unsigned char> state{Available};
+        double salePrice = 0.0;                        // written before soldVersion
+        std::atomic<std::uint64_t> soldVersion{kNotSold};
+    };
+
+    // Cars live in fixed-size chunks that never move, so readers can walk
+    // them without a lock while new cars are added. The car with ID id is
+    // in shard id & mask, at slot id >> shard bits.
+    static constexpr std::size_t kChunkBits = 12;
+    static constexpr std::size_t kChunkSize = std::size_t(1) << kChunkBits;
+    static constexpr std::size_t kMaxChunks = 4096;
+
+    // Padded to its own cache lines, so busy shards do not slow their neighbours down.
+    struct alignas(64) Shard
+    {
+        std::mutex mutex; // taken for adding only
+        std::unique_ptr<std::atomic<Entry *>[]> chunks; // allocated on first use, freed with the shard
+        std::atomic<std::uint64_t> addingVersion{kNoAdd}; // version of the add running right now
+
+        Shard() : chunks(new std::atomic<Entry *>[kMaxChunks])
+        {
+            for (std::size_t chunk = 0; chunk < kMaxChunks; chunk++)
+            {
+                chunks[chunk].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+        ~Shard();
+
+        /// The entry at a slot, or null if its chunk was never allocated.
+        Entry *Find(std::size_t slot) const
+        {
+            Entry *chunk = chunks[slot >> kChunkBits].load(std::memory_order_acquire);
+            return chunk != nullptr ? chunk + (slot & (kChunkSize - 1)) : nullptr;
+        }
+    };
+
+    std::unique_ptr<Shard[]> _shards;
+    std::size_t _shardMask;
+    unsigned int _shardBits;
+    DepreciationPricer _depreciation;
+    const Clock *_clock;
+
+    alignas(64) std::atomic<unsigned int> _nextCarId;
+    alignas(64) std::atomic<std::size_t> _carCount;
+    alignas(64) std::atomic<std::size_t> _soldCount;
+    alignas(64) std::atomic<std::uint64_t> _nextVersion;
+
+    Shard &ShardOf(unsigned int id) const { return _shards[id & _shardMask]; }
+    std::size_t SlotOf(unsigned int id) const { return id >> _shardBits; }
+
+    /// The added car with this ID, or null. Needs no lock.
+    Entry *FindCar(unsigned int id) const;
+
+    /// Waits until no add that a view at this version has to show is still running.
+    void WaitForAdds(std::uint64_t version) const;
+
+    /// The version the car was sold at, or kNotSold; waits if a sale is half done.
+    static std::uint64_t SoldVersion(const Entry &car);
+
+public:
+    /**
+     * @brief Creates an empty inventory.
+     *
+     * @param shardCount How many shards to use; rounded up to a power of two.
+     *                   0 picks a number based on the CPU count.
+     * @param depreciation The pricing rule used for sales.
+     * @param clock Where add and sale times come from; it must outlive the manager.
+     *              A CoarseClock keeps the time lookup off the sell path.
+     */
+    explicit ConcurrentCarManager(std::size_t shardCount = 0,
+                                  const DepreciationSchedule &depreciation = kDefaultDepreciation,
+                                  const Clock &clock = DefaultClock());
+
+    /**
+     * @brief Adds a new car and returns its ID.
+     *
+     * IDs come from an atomic counter, so concurrent adds never get the same ID.
+     *
+     * @return The new car's ID, or 0 if its shard is full.
+     */
+    unsigned int AddCar(std::string_view model, unsigned int registerYear, double initialPrice);
+
+    /**
+     * @brief Tries to sell a car.
+     *
+     * Safe to call from any number of threads; if several of them sell the
+     * same car at once, exactly one gets true.
+     *
+     * @param id The unique ID of the car to sell.
+     * @param salePrice If not null, receives the price the car was sold for.
+     * @return true if this call sold the car, false if it is unknown or already sold.
+     */
+    bool SellCar(unsigned int id, double *salePrice = nullptr);
+
+    /**
+     * @brief Checks if a car is sold (a sale in progress counts as sold).
+     */
+    bool IsCarSold(unsigned int id) const;
+
+    /**
+     * @brief Gets the price a car was sold for.
+     *
+     * @return true and the price if the car is sold, false otherwise.
+     */
+    bool GetSalePrice(unsigned int id, double &salePrice) const;
+
+    /**
+     * @brief Gets a consistent, read-only view of the inventory as it is right now.
+     *
+     * Taking a view costs two atomic reads. The view keeps showing the same
+     * inventory however many cars are added or sold afterwards.
+     * It must not outlive the manager.
+     */
+    InventoryView GetView() const;
+
+    std::size_t GetCarCount() const { return _carCount.load(std::memory_order_relaxed); }
+    std::size_t GetSoldCount() const { return _soldCount.load(std::memory_order_relaxed); }
+    unsigned int GetNextCarId() const { return _nextCarId.load(std::memory_order_relaxed); }
+    std::size_t GetShardCount() const { return _shardMask + 1; }
+};
+
+/**
+ * @brief One car as seen through an InventoryView.
+ */
+struct CarSnapshot
+{
+    unsigned int id;
+    std::string_view model;
+    unsigned int registerYear;
+    double initialPrice;
+    std::chrono::system_clock::time_point addTime;
+    bool isSold;
+    double salePrice;
+};
+
+/**
+ * @brief The inventory of a ConcurrentCarManager frozen at one version.
+ *
+ * Cars added after the view was taken are not in it, and cars sold after
+ * it was taken still show as available. Reading never takes a lock.
+ */
+class InventoryView
+{
+
+private:
+    const ConcurrentCarManager *_manager;
+    std::uint64_t _version;
+    unsigned int _lastId; // no car in the view has a higher ID
+
+public:
+    InventoryView(const ConcurrentCarManager &manager, std::uint64_t version, unsigned int lastId)
+        : _manager(&manager), _version(version), _lastId(lastId){};
+
+    std::uint64_t GetVersion() const { return _version; }
+
+    /**
+     * @brief Calls visit(car) for every car in the view, ordered by ID.
+     *
+     * Cars are stored by ID, so this is one pass with no copy and no sorting.
+     */
+    template <typename Visitor>
+    void ForEachCar(Visitor visit) const;
+
+    /**
+     * @brief Gets every car in the view, ordered by ID.
+     */
+    std::vector<CarSnapshot> GetCars() const;
+
+    /**
+     * @brief Prints the available cars with their current price, like CarManager::ShowAvailableCars.
+     */
+    void ShowAvailableCars(std::ostream &out, std::chrono::system_clock::time_point currentTime) const;
+
+    /**
+     * @brief Prints the day report, like CarManager::ShowDailyReport.
+     */
+    void ShowDailyReport(std::ostream &out) const;
+};
+
+template <typename Visitor>
+void InventoryView::ForEachCar(Visitor visit) const
+{
+    _manager->WaitForAdds(_version);
+
+    for (unsigned int id = 1; id <= _lastId; id++)
+    {
+        const ConcurrentCarManager::Entry *car = _manager->FindCar(id);
+        if (car == nullptr || car->addedVersion.load(std::memory_order_acquire) > _version)
+        {
+            continue; // never added (its shard was full) or added after the view
+        }
+
+        bool sold = ConcurrentCarManager::SoldVersion(*car) <= _version;
+        visit(CarSnapshot{car->id, car->model, car->registerYear, car->initialPrice, car->addTime,
+                          sold, sold ? car->salePrice : 0.0});
+    }
+}
@@ -0,0 +1,536 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <variant>
+
+/**
+ * @brief Depreciation schedules (pricing rules) for cars.
+ *
+ * Every schedule works the same way in time: the price stays the same for
+ * a grace period, and after that it changes in steps of fixed length.
+ * Step 0 is the grace period, step 1 starts right after it, and so on.
+ * The schedules only differ in how big the discount is at each step.
+ *
+ * A schedule is a small value type with constexpr methods, so it can be
+ * passed as a template parameter to the pricing functions below; then the
+ * whole rule is inlined into the pricing loop. For deployments that pick the
+ * rule from configuration, DepreciationSchedule holds any of them and is
+ * dispatched once per batch of cars, never once per car.
+ *
+ * Each schedule provides:
+ *   - StepIndex(elapsedSeconds): the step reached after that many seconds,
+ *   - MultiplierAtStep(step): the price multiplier (1 - discount) at a step,
+ *   - SaturationStep(): the step after which the price no longer changes,
+ *   - UncappedMultiplierAtStep(step): same as MultiplierAtStep for steps
+ *     from 1 up to SaturationStep(), written without comparisons so that
+ *     batch pricing loops can be vectorized.
+ */
+
+#if defined(__GNUC__) && defined(__x86_64__) && defined(__linux__)
+/// Builds an AVX2 and a generic version of a pricing loop; the right one is picked at run time.
+#define CAR_PRICE_KERNEL_CLONES __attribute__((target_clones("avx2", "default")))
+#else
+#define CAR_PRICE_KERNEL_CLONES
+#endif
+
+#if defined(__GNUC__)
+#define CAR_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define CAR_ALWAYS_INLINE inline
+#endif
+
+namespace DepreciationDetail
+{
+    // Step 0 during the grace period, then one more step every stepSeconds.
+    constexpr long long StepIndex(long long elapsedSeconds, long long graceSeconds, long long stepSeconds)
+    {
+        return elapsedSeconds > graceSeconds ? 1 + (elapsedSeconds - graceSeconds) / stepSeconds : 0;
+    }
+}
+
+/**
+ * @brief Linear steps: a fixed extra discount every step, up to a cap.
+ *
+ * The default values are the dealership's classic rule: 0.1% after 30
+ * seconds, another 0.1% every 10 seconds, at most 20%.
+ */
+struct LinearDepreciation
+{
+    long long graceSeconds = 30;
+    long long stepSeconds = 10;
+    double firstDiscount = 0.001; ///< Discount at step 1.
+    double stepDiscount = 0.001;  ///< Extra discount for every following step.
+    double maxDiscount = 0.20;
+
+    constexpr long long StepIndex(long long elapsedSeconds) const
+    {
+        return DepreciationDetail::StepIndex(elapsedSeconds, graceSeconds, stepSeconds);
+    }
+
+    constexpr double MultiplierAtStep(long long step) const
+    {
+        if (step <= 0)
+        {
+            return 1.0;
+        }
+        double discount = Discount(step);
+        return 1.0 - (discount < maxDiscount ? discount : maxDiscount);
+    }
+
+    constexpr double UncappedMultiplierAtStep(int step) const { return 1.0 - (firstDiscount + stepDiscount * (step - 1)); }
+
+    constexpr long long SaturationStep() const
+    {
+        if (stepDiscount <= 0)
+        {
+            return firstDiscount >= maxDiscount ? 1 : kMaxSteps;
+        }
+
+        // Start from the closed form and fix up rounding, so the answer is exact.
+        double estimate = (maxDiscount - firstDiscount) / stepDiscount + 1;
+        long long step = estimate < 1 ? 1 : (estimate > kMaxSteps ? kMaxSteps : static_cast<long long>(estimate));
+        while (step > 1 && Discount(step - 1) >= maxDiscount)
+        {
+            step--;
+        }
+        while (step < kMaxSteps && Discount(step) < maxDiscount)
+        {
+            step++;
+        }
+        return step;
+    }
+
+    constexpr double Discount(long long step) const { return firstDiscount + stepDiscount * (step - 1); }
+
+    static constexpr long long kMaxSteps = 1 << 20;
+};
+
+/**
+ * @brief Exponential decay: the price loses a fixed share of its value every step, down to a floor.
+ */
+struct ExponentialDepreciation
+{
+    long long graceSeconds = 30;
+    long long stepSeconds = 10;
+    double stepRate = 0.001;   ///< Share of the value lost at every step.
+    double maxDiscount = 0.20; ///< The price never drops below (1 - maxDiscount) of the initial price.
+
+    constexpr long long StepIndex(long long elapsedSeconds) const
+    {
+        return DepreciationDetail::StepIndex(elapsedSeconds, graceSeconds, stepSeconds);
+    }
+
+    constexpr double MultiplierAtStep(long long step) const
+    {
+        // (1 - rate)^step by repeated squaring, so it also works at compile time.
+        double result = 1.0;
+        double base = 1.0 - stepRate;
+        for (long long e = step > 0 ? step : 0; e > 0; e /= 2)
+        {
+            if (e % 2 == 1)
+            {
+                result *= base;
+            }
+            base *= base;
+        }
+        return result > 1.0 - maxDiscount ? result : 1.0 - maxDiscount;
+    }
+
+    constexpr double UncappedMultiplierAtStep(int step) const { return MultiplierAtStep(step); }
+
+    constexpr long long SaturationStep() const
+    {
+        long long step = 1;
+        while (MultiplierAtStep(step) > 1.0 - maxDiscount && step < kMaxSteps)
+        {
+            step++;
+        }
+        return step;
+    }
+
+    static constexpr long long kMaxSteps = 1 << 16;
+};
+
+/**
+ * @brief A discount curve given as a table: one discount per step, the last one holds forever.
+ */
+struct TabulatedDepreciation
+{
+    static constexpr std::size_t kMaxPoints = 64;
+
+    long long graceSeconds = 30;
+    long long stepSeconds = 10;
+    std::array<double, kMaxPoints> discounts = {}; ///< discounts[i] applies at step i + 1.
+    std::size_t count = 0;
+
+    constexpr long long StepIndex(long long elapsedSeconds) const
+    {
+        return DepreciationDetail::StepIndex(elapsedSeconds, graceSeconds, stepSeconds);
+    }
+
+    constexpr double MultiplierAtStep(long long step) const
+    {
+        if (step <= 0 || count == 0)
+        {
+            return 1.0;
+        }
+        std::size_t point = static_cast<std::size_t>(step) < count ? static_cast<std::size_t>(step) : count;
+        return 1.0 - discounts[point - 1];
+    }
+
+    constexpr double UncappedMultiplierAtStep(int step) const { return 1.0 - discounts[step - 1]; }
+
+    constexpr long long SaturationStep() const { return count > 0 ? static_cast<long long>(count) : 1; }
+};
+
+/// The classic dealership rule, the default everywhere.
+constexpr LinearDepreciation kDefaultDepreciation{};
+
+static_assert(kDefaultDepreciation.MultiplierAtStep(0) == 1.0, "no discount during the grace period");
+static_assert(kDefaultDepreciation.StepIndex(30) == 0 && kDefaultDepreciation.StepIndex(31) == 1, "discount starts after 30 s");
+static_assert(kDefaultDepreciation.StepIndex(39) == 1 && kDefaultDepreciation.StepIndex(40) == 2, "one step every 10 s");
+static_assert(kDefaultDepreciation.SaturationStep() == 200, "20% cap is reached at step 200");
+static_assert(kDefaultDepreciation.MultiplierAtStep(5000) == 1.0 - 0.20, "discount is capped at 20%");
+
+/**
+ * @brief Any schedule turned into a lookup table: one price multiplier per step.
+ *
+ * Every schedule only looks at the step index, and every one of them stops
+ * changing at its saturation step (step 200 for the default rule), so all
+ * its multipliers fit in a small array. A table is a schedule itself and
+ * can be used with all the pricing functions below; pricing a car then
+ * costs one step computation, one load and one multiply, whatever rule the
+ * table came from. Steps past the saturation step read its multiplier.
+ *
+ * Tables are built with MakeMultiplierTable, also at compile time, and
+ * MatchesSchedule checks a table against its schedule step by step, so
+ * every constexpr table can be verified with a static_assert.
+ */
+template <std::size_t Capacity>
+struct MultiplierTable
+{
+    static_assert(Capacity >= 2, "a table needs the grace period and at least one step");
+
+    long long graceSeconds = 30;
+    long long stepSeconds = 10;
+    long long lastStep = 1;                        ///< The saturation step of the schedule.
+    std::array<double, Capacity> multipliers = {}; ///< multipliers[s] is the multiplier at step s.
+
+    constexpr long long StepIndex(long long elapsedSeconds) const
+    {
+        return DepreciationDetail::StepIndex(elapsedSeconds, graceSeconds, stepSeconds);
+    }
+
+    constexpr double MultiplierAtStep(long long step) const
+    {
+        return multipliers[static_cast<std::size_t>(step <= 0 ? 0 : (step < lastStep ? step : lastStep))];
+    }
+
+    constexpr double UncappedMultiplierAtStep(int step) const { return multipliers[static_cast<std::size_t>(step)]; }
+
+    constexpr long long SaturationStep() const { return lastStep; }
+};
+
+/**
+ * @brief Checks if a schedule saturates early enough to fit in a table of the given size.
+ */
+template <std::size_t Capacity, typename Policy>
+constexpr bool FitsMultiplierTable(const Policy &policy)
+{
+    return policy.SaturationStep() < static_cast<long long>(Capacity);
+}
+
+/**
+ * @brief Builds the multiplier table of a schedule; check FitsMultiplierTable first.
+ */
+template <std::size_t Capacity, typename Policy>
+constexpr MultiplierTable<Capacity> MakeMultiplierTable(const Policy &policy)
+{
+    MultiplierTable<Capacity> table;
+    table.graceSeconds = policy.graceSeconds;
+    table.stepSeconds = policy.stepSeconds;
+
+    long long last = policy.SaturationStep();
+    table.lastStep = last < static_cast<long long>(Capacity) ? last : static_cast<long long>(Capacity) - 1;
+
+    // The slots past the saturation step repeat its multiplier, so any index below Capacity is valid.
+    for (std::size_t step = 0; step < Capacity; step++)
+    {
+        long long clamped = static_cast<long long>(step) < table.lastStep ? static_cast<long long>(step) : table.lastStep;
+        table.multipliers[step] = policy.MultiplierAtStep(clamped);
+    }
+    return table;
+}
+
+/**
+ * @brief Checks that a table prices every step exactly like the schedule it was made from.
+ */
+template <std::size_t Capacity, typename Policy>
+constexpr bool MatchesSchedule(const MultiplierTable<Capacity> &table, const Policy &policy)
+{
+    if (table.graceSeconds != policy.graceSeconds || table.stepSeconds != policy.stepSeconds ||
+        table.lastStep != policy.SaturationStep())
+    {
+        return false;
+    }
+
+    for (long long step = 0; step <= table.lastStep + 1; step++)
+    {
+        if (table.MultiplierAtStep(step) != policy.MultiplierAtStep(step))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// The classic rule as a table; Car prices with it.
+constexpr auto kDefaultMultiplierTable =
+    MakeMultiplierTable<kDefaultDepreciation.SaturationStep() + 1>(kDefaultDepreciation);
+
+static_assert(MatchesSchedule(kDefaultMultiplierTable, kDefaultDepreciation), "default table prices like the default rule");
+static_assert(kDefaultMultiplierTable.multipliers.size() == 201, "one multiplier per step up to the 20% cap");
+
+/// A depreciation schedule chosen at run time (for example from a config file).
+using DepreciationSchedule = std::variant<LinearDepreciation, ExponentialDepreciation, TabulatedDepreciation>;
+
+
+namespace DepreciationDetail
+{
+    using Ticks = std::chrono::system_clock::rep;
+    constexpr Ticks kTicksPerSecond = std::chrono::system_clock::period::den / std::chrono::system_clock::period::num;
+
+    // Exact int64 -> double for |value| < 2^51; unlike a plain cast this vectorizes without AVX-512.
+    inline double TicksToDouble(Ticks value)
+    {
+        std::int64_t biased = static_cast<std::int64_t>(value) + 0x4338000000000000LL;
+        double result;
+        std::memcpy(&result, &biased, sizeof(result));
+        return result - 6755399441055744.0;
+    }
+
+    inline Ticks Clamp(Ticks value, Ticks low, Ticks high)
+    {
+        value = value < low ? low : value;
+        return value > high ? high : value;
+    }
+
+    inline int ClampInt(int value, int low, int high)
+    {
+        value = value < low ? low : value;
+        return value > high ? high : value;
+    }
+
+    // Longest time span TicksToDouble handles exactly, in whole seconds (about 26 days).
+    constexpr long long kMaxExactSeconds = (1LL << 51) / kTicksPerSecond;
+
+    // Seconds after which the price of this schedule never changes again.
+    template <typename Policy>
+    constexpr long long SaturationSeconds(const Policy &policy)
+    {
+        return policy.graceSeconds + (policy.SaturationStep() - 1) * policy.stepSeconds + 1;
+    }
+}
+
+/**
+ * @brief Calculates the depreciated price of one car under the given schedule.
+ *
+ * @param policy The depreciation schedule.
+ * @param initialPrice The price the car was first listed at.
+ * @param addTime When the car was added.
+ * @param currentTime The current system time point.
+ * @return The current price.
+ */
+template <typename Policy>
+double DepreciatedPrice(const Policy &policy, double initialPrice, std::chrono::system_clock::time_point addTime,
+                        std::chrono::system_clock::time_point currentTime)
+{
+    auto elapsedSeconds = std::chrono::duration_cast<std::chrono::seconds>(currentTime - addTime).count();
+    return initialPrice * policy.MultiplierAtStep(policy.StepIndex(elapsedSeconds));
+}
+
+/**
+ * @brief Tells when the price of a car changes next under the given schedule.
+ *
+ * Prices only move at step boundaries, so between now and the returned
+ * time DepreciatedPrice gives the same value for the car.
+ *
+ * @return The time the next step starts, or time_point::max() once the price is capped.
+ */
+template <typename Policy>
+std::chrono::system_clock::time_point NextPriceChange(const Policy &policy, std::chrono::system_clock::time_point addTime,
+                                                      std::chrono::system_clock::time_point currentTime)
+{
+    auto elapsedSeconds = std::chrono::duration_cast<std::chrono::seconds>(currentTime - addTime).count();
+    long long step = policy.StepIndex(elapsedSeconds);
+
+    if (step >= policy.SaturationStep())
+    {
+        return std::chrono::system_clock::time_point::max();
+    }
+
+    // Step 1 starts one second after the grace period, step s + 1 at grace + s * step.
+    long long nextSeconds = step == 0 ? policy.graceSeconds + 1 : policy.graceSeconds + step * policy.stepSeconds;
+    return addTime + std::chrono::seconds(nextSeconds);
+}
+
+/**
+ * @brief Calculates depreciated prices for many cars in one pass under the given schedule.
+ *
+ * Gives exactly the same results as DepreciatedPrice for every car. Time
+ * is clamped to the schedule's saturation point with integer operations
+ * only, so for simple schedules that saturate within a few weeks the loop
+ * compiles to branch-free SIMD code when it is inlined into a function
+ * built for a SIMD target (see CAR_PRICE_KERNEL_CLONES).
+ *
+ * @param schedule The depreciation schedule.
+ * @param addTimes When each car was added, as system_clock ticks since the epoch.
+ * @param initialPrices The listed price of each car.
+ * @param count How many cars there are.
+ * @param currentTime The current system time point.
+ * @param prices Receives the current price of each car.
+ */
+template <typename Policy>
+CAR_ALWAYS_INLINE void DepreciatedPrices(const Policy &schedule, const std::chrono::system_clock::rep *addTimes, const double *initialPrices,
+                                         std::size_t count, std::chrono::system_clock::time_point currentTime, double *prices)
+{
+    using namespace DepreciationDetail;
+
+    // A local copy, so the compiler knows writing prices cannot change the schedule.
+    const Policy policy = schedule;
+
+    const Ticks now = currentTime.time_since_epoch().count();
+    const int graceSeconds = static_cast<int>(policy.graceSeconds);
+    const double stepSeconds = static_cast<double>(policy.stepSeconds);
+    const int saturationStep = static_cast<int>(policy.SaturationStep());
+    const double saturationMultiplier = policy.MultiplierAtStep(saturationStep);
+    const long long saturationSeconds = SaturationSeconds(policy);
+
+    // Schedules that keep changing for weeks do not fit the fast loop below.
+    if (saturationSeconds > kMaxExactSeconds)
+    {
+        for (std::size_t i = 0; i < count; i++)
+        {
+            std::chrono::system_clock::time_point addTime{std::chrono::system_clock::duration(addTimes[i])};
+            prices[i] = DepreciatedPrice(policy, initialPrices[i], addTime, currentTime);
+        }
+        return;
+    }
+
+    const Ticks saturation = saturationSeconds * kTicksPerSecond;
+
+    // Everything below is 32-bit integer or double math with min/max instead of
+    // branches, which is what AVX2 can do on whole vectors at once.
+    for (std::size_t i = 0; i < count; i++)
+    {
+        // Before the add time counts as "no time passed", after saturation nothing changes.
+        Ticks elapsed = Clamp(now - addTimes[i], 0, saturation);
+        int seconds = static_cast<int>(TicksToDouble(elapsed) / kTicksPerSecond);
+
+        // StepIndex(seconds): 0 in the grace period, else 1 + (seconds - grace) / step.
+        int past = ClampInt(seconds - graceSeconds, 0, seconds);
+        int started = ClampInt(past, 0, 1);
+        int step = started * static_cast<int>((past + stepSeconds) / stepSeconds);
+
+        // Blend grace period, stepping and saturation with exact 0/1 factors;
+        // the result equals MultiplierAtStep(step).
+        double stepping = policy.UncappedMultiplierAtStep(ClampInt(step, 1, saturationStep));
+        double active = started;
+        double saturated = ClampInt(step - saturationStep + 1, 0, 1);
+        double multiplier = active * ((1.0 - saturated) * stepping + saturated * saturationMultiplier) + (1.0 - active);
+        prices[i] = initialPrices[i] * multiplier;
+    }
+}
+
+/**
+ * @brief Calculates one depreciated price under a schedule chosen at run time.
+ */
+inline double DepreciatedPrice(const DepreciationSchedule &schedule, double initialPrice,
+                               std::chrono::system_clock::time_point addTime,
+                               std::chrono::system_clock::time_point currentTime)
+{
+    return std::visit([&](const auto &policy)
+                      { return DepreciatedPrice(policy, initialPrice, addTime, currentTime); },
+                      schedule);
+}
+
+/**
+ * @brief Calculates many depreciated prices under a schedule chosen at run time.
+ *
+ * The schedule is looked at once, then the matching inlined loop runs over all cars.
+ */
+void DepreciatedPrices(const DepreciationSchedule &schedule, const std::chrono::system_clock::rep *addTimes,
+                       const double *initialPrices, std::size_t count,
+                       std::chrono::system_clock::time_point currentTime, double *prices);
+
+/**
+ * @brief Prices cars under a schedule chosen at run time, through its multiplier table.
+ *
+ * The table is built once when the pricer is made, so every price after
+ * that is a table lookup instead of the schedule's formula. Schedules that
+ * keep changing for more than kTableSteps steps are priced with their
+ * formula instead; the results are the same either way.
+ */
+class DepreciationPricer
+{
+
+public:
+    static constexpr std::size_t kTableSteps = 1024;
+
+private:
+    DepreciationSchedule _schedule;
+    MultiplierTable<kTableSteps> _table;
+    bool _useTable;
+
+public:
+    DepreciationPricer(const DepreciationSchedule &schedule = kDefaultDepreciation);
+
+    const DepreciationSchedule &Schedule() const { return _schedule; }
+
+    /// Whether prices come from the table (false only for schedules that saturate very late).
+    bool UsesTable() const { return _useTable; }
+
+    double Price(double initialPrice, std::chrono::system_clock::time_point addTime,
+                 std::chrono::system_clock::time_point currentTime) const
+    {
+        return _useTable ? DepreciatedPrice(_table, initialPrice, addTime, currentTime)
+                         : DepreciatedPrice(_schedule, initialPrice, addTime, currentTime);
+    }
+
+    /// The price multiplier after the given number of whole seconds.
+    double MultiplierAfter(long long elapsedSeconds) const
+    {
+        return _useTable ? _table.MultiplierAtStep(_table.StepIndex(elapsedSeconds))
+                         : std::visit([&](const auto &policy)
+                                      { return policy.MultiplierAtStep(policy.StepIndex(elapsedSeconds)); },
+                                      _schedule);
+    }
+
+    /// Whether the price is capped (never changes again) after the given number of whole seconds.
+    bool IsCappedAfter(long long elapsedSeconds) const
+    {
+        return _useTable ? _table.StepIndex(elapsedSeconds) >= _table.SaturationStep()
+                         : std::visit([&](const auto &policy)
+                                      { return policy.StepIndex(elapsedSeconds) >= policy.SaturationStep(); },
+                                      _schedule);
+    }
+
+    std::chrono::system_clock::time_point NextChange(std::chrono::system_clock::time_point addTime,
+                                                     std::chrono::system_clock::time_point currentTime) const
+    {
+        return _useTable ? NextPriceChange(_table, addTime, currentTime)
+                         : std::visit([&](const auto &policy)
+                                      { return NextPriceChange(policy, addTime, currentTime); },
+                                      _schedule);
+    }
+
+    /**
+     * @brief Same as DepreciatedPrices for the pricer's schedule.
+     */
+    void Prices(const std::chrono::system_clock::rep *addTimes, const double *initialPrices, std::size_t count,
+                std::chrono::system_clock::time_point currentTime, double *prices) const;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Maps car IDs to their position (slot) in the inventory.
+ *
+ * A small open-addressing hash map with linear probing, so finding a car
+ * by its ID takes constant time no matter how big the inventory is.
+ * All keys and slots live in two flat arrays, which keeps lookups
+ * cache friendly. The table grows automatically when it gets too full.
+ */
+class IdIndex
+{
+
+private:
+    std::vector<unsigned int> _keys;
+    std::vector<std::size_t> _slots;
+    std::size_t _size;
+    std::size_t _mask;
+
+    std::size_t Bucket(unsigned int id) const;
+    void Rehash(std::size_t newCapacity);
+
+public:
+    /// Returned by Find() when the ID is not in the index.
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    IdIndex() : _size(0), _mask(0){};
+
+    /**
+     * @brief Finds the inventory slot of a car.
+     *
+     * @param id The unique ID of the car.
+     * @return The slot stored for this ID, or npos if the ID is unknown.
+     */
+    std::size_t Find(unsigned int id) const;
+
+    /**
+     * @brief Remembers the slot of a car.
+     *
+     * If the ID is already in the index the old slot is kept, so the first
+     * car with a given ID wins (same as a linear search would do).
+     *
+     * @param id The unique ID of the car.
+     * @param slot The position of the car in the inventory.
+     * @return true if the ID was added, false if it was already indexed.
+     */
+    bool Insert(unsigned int id, std::size_t slot);
+
+    /**
+     * @brief Makes room for at least the given number of IDs without rehashing.
+     */
+    void Reserve(std::size_t count);
+
+    /**
+     * @brief Removes all IDs from the index.
+     */
+    void Clear();
+
+    /**
+     * @brief Gets the number of IDs stored in the index.
+     */
+    std::size_t Size() const { return _size; }
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+/**
+ * @brief How an attempt to sell a car ended.
+ */
+enum class SaleStatus
+{
+    Sold,        ///< The car was sold now.
+    AlreadySold, ///< The car had been sold before.
+    NotFound,    ///< No car has this ID.
+};
+
+/**
+ * @brief The outcome of selling one car.
+ */
+struct SaleResult
+{
+    unsigned int id = 0;
+    SaleStatus status = SaleStatus::NotFound;
+    double salePrice = 0.0; ///< Only set when status is Sold.
+};
+
+/**
+ * @brief How important a message from the inventory is.
+ */
+enum class EventLevel
+{
+    Info,
+    Warning,
+    Error,
+};
+
+/**
+ * @brief Receives what happens in a CarManager, instead of it printing to the console.
+ *
+ * Every method does nothing by default, so this class itself is the "null"
+ * sink, and a sink only has to override what it cares about. The console
+ * messages of the program are produced by a sink in main.cpp.
+ * The string views are only valid during the call.
+ */
+class InventoryEventSink
+{
+
+public:
+    virtual ~InventoryEventSink() = default;
+
+    /// A car was added to the inventory.
+    virtual void CarAdded(unsigned int /*id*/, std::string_view /*model*/, unsigned int /*registerYear*/,
+                          double /*initialPrice*/) {}
+
+    /// Someone tried to sell a car; model is empty when the ID was not found.
+    virtual void SaleAttempted(const SaleResult & /*result*/, std::string_view /*model*/) {}
+
+    /// A line of an inventory file could not be read and was skipped.
+    virtual void LineSkipped(std::size_t /*lineNumber*/, std::string_view /*line*/, std::string_view /*error*/) {}
+
+    /// Anything else worth telling, like a file that was loaded or could not be opened.
+    virtual void Message(EventLevel /*level*/, std::string_view /*text*/) {}
+};
+
+/**
+ * @brief The shared sink that ignores every event.
+ */
+inline InventoryEventSink &NullEventSink()
+{
+    static InventoryEventSink sink;
+    return sink;
+}
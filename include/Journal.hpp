@@ -0,0 +1,139 @@
+#pragma once
+
+#include "InventoryEvents.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief One change to the inventory, as stored in the journal.
+ */
+struct JournalRecord
+{
+    enum class Type : std::uint32_t
+    {
+        Add = 1,  ///< A car was added (all fields except salePrice are set).
+        Sell = 2, ///< A car was sold (id and salePrice are set).
+    };
+
+    Type type = Type::Add;
+    unsigned int id = 0;
+    unsigned int registerYear = 0;
+    double initialPrice = 0.0;
+    std::int64_t addTime = 0; ///< system_clock ticks
+    double salePrice = 0.0;
+    std::string_view model;
+};
+
+/**
+ * @brief Append-only write-ahead journal of inventory changes.
+ *
+ * Instead of rewriting the whole inventory after every change, each
+ * AddCar or SellCar appends one small record to this file. Every record is
+ * handed to the operating system right away, so a crash of the program
+ * loses nothing; the expensive fsync (which protects against power loss)
+ * is only done once per batch of records, or when Sync() is called.
+ *
+ * Records carry a checksum, so a record that was only half written when the
+ * machine went down is detected and dropped when the journal is reopened.
+ *
+ * The journal prints nothing; problems go to the message handler, if one is set.
+ */
+class Journal
+{
+
+public:
+    using MessageHandler = std::function<void(EventLevel level, const std::string &text)>;
+
+private:
+    std::FILE *_file;
+    std::size_t _recordCount;
+    std::size_t _unsyncedCount;
+    std::size_t _syncEvery;
+    MessageHandler _onMessage;
+
+    static void Encode(JournalRecord::Type type, const void *payload, std::size_t size, std::string_view extra,
+                       std::vector<char> &buffer);
+    bool Write(const std::vector<char> &buffer, std::size_t recordCount);
+    void Report(EventLevel level, const std::string &text) const;
+
+public:
+    Journal() : _file(nullptr), _recordCount(0), _unsyncedCount(0), _syncEvery(64){};
+    ~Journal();
+
+    Journal(const Journal &) = delete;
+    Journal &operator=(const Journal &) = delete;
+
+    /**
+     * @brief Sets where errors and warnings (like a dropped damaged tail) are sent.
+     */
+    void SetMessageHandler(MessageHandler handler) { _onMessage = std::move(handler); }
+
+    /**
+     * @brief Opens (or creates) a journal file and replays what is already in it.
+     *
+     * Every valid record is passed to the callback in the order it was written.
+     * A damaged or unfinished tail is cut off, and new records are appended
+     * after the last good one.
+     *
+     * @param filename The path to the journal file.
+     * @param replay Called once for every record found in the file.
+     * @return true if the journal is ready for appending, false if it could not be opened
+     *         or its damaged tail could not be cut off.
+     */
+    bool Open(const std::string &filename, const std::function<void(const JournalRecord &)> &replay);
+
+    /**
+     * @brief Closes the journal, syncing whatever is still pending.
+     */
+    void Close();
+
+    bool IsOpen() const { return _file != nullptr; }
+
+    /**
+     * @brief Appends an "add car" record.
+     */
+    bool AppendAdd(unsigned int id, std::string_view model, unsigned int registerYear,
+                   double initialPrice, std::int64_t addTime);
+
+    /**
+     * @brief Appends a "sell car" record.
+     */
+    bool AppendSell(unsigned int id, double salePrice);
+
+    /**
+     * @brief Appends many records with a single write.
+     */
+    bool AppendRecords(const std::vector<JournalRecord> &records);
+
+    /**
+     * @brief Forces all appended records to disk (fsync).
+     *
+     * @return true if every record is on disk; false if the journal is not
+     *         open or the sync failed (reported to the message handler).
+     */
+    bool Sync();
+
+    /**
+     * @brief Throws away every record, leaving an empty journal.
+     *
+     * Used after the records were folded into a snapshot.
+     *
+     * @return true if the journal was emptied and synced.
+     */
+    bool Truncate();
+
+    /**
+     * @brief Sets after how many records the journal syncs to disk on its own.
+     */
+    void SetSyncEvery(std::size_t records) { _syncEvery = records > 0 ? records : 1; }
+
+    /**
+     * @brief Gets the number of records in the journal (replayed plus appended).
+     */
+    std::size_t GetRecordCount() const { return _recordCount; }
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Read-only view of a whole file mapped into memory.
+ *
+ * On POSIX systems the file is mapped with mmap, so its bytes can be read
+ * in place without copying them into our own buffers. On other systems
+ * the file is simply read into memory once.
+ * The mapping is released automatically when the object is destroyed.
+ */
+class MappedFile
+{
+
+private:
+    const char *_data;
+    std::size_t _size;
+    std::string _fallback; // used when the platform has no mmap
+
+    void Close();
+
+public:
+    MappedFile() : _data(nullptr), _size(0){};
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+     * @brief Maps the given file into memory.
+     *
+     * Any previously opened file is released first.
+     *
+     * @param filename The path to the file.
+     * @return true if the file could be opened (an empty file is fine), false otherwise.
+     */
+    bool Open(const std::string &filename);
+
+    /**
+     * @brief Gets the file contents. Valid until the file is closed or reopened.
+     */
+    std::string_view Data() const { return std::string_view(_data, _size); }
+
+    std::size_t Size() const { return _size; }
+};
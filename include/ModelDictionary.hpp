@@ -0,0 +1,74 @@
+#pragma once
+
+#include "StringArena.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Gives every distinct model name a small number (its model ID).
+ *
+ * An inventory has millions of cars but only a few thousand models, so each
+ * name is stored once, in a string arena, and cars only keep its 32-bit ID.
+ * IDs are handed out in the order names are first seen (0, 1, 2, ...), so
+ * they can index plain arrays. Comparing or grouping models by ID is a plain
+ * integer operation.
+ */
+class ModelDictionary
+{
+
+private:
+    StringArena _arena;                                        // the names' characters
+    std::vector<std::string_view> _names;                      // per model ID, pointing into _arena
+    std::unordered_map<std::string_view, std::uint32_t> _ids;  // name -> model ID
+
+public:
+    /// Returned by Find() when the name is not in the dictionary.
+    static constexpr std::uint32_t npos = static_cast<std::uint32_t>(-1);
+
+    ModelDictionary() = default;
+
+    ModelDictionary(const ModelDictionary &) = delete;
+    ModelDictionary &operator=(const ModelDictionary &) = delete;
+
+    /**
+     * @brief Gets the model ID of a name, adding the name if it is new.
+     */
+    std::uint32_t Intern(std::string_view name);
+
+    /**
+     * @brief Gets the model ID of a name without adding it.
+     *
+     * @return The model ID, or npos if no car ever had this name.
+     */
+    std::uint32_t Find(std::string_view name) const;
+
+    /**
+     * @brief Gets the name of a model ID; the view is valid until Clear().
+     */
+    std::string_view Name(std::uint32_t id) const { return _names[id]; }
+
+    /**
+     * @brief Replaces the dictionary with names packed back to back, like in a snapshot.
+     *
+     * @param starts count + 1 offsets into pool; name i is pool[starts[i], starts[i + 1]).
+     * @param pool All names, back to back.
+     * @param count The number of names.
+     */
+    void Assign(const std::uint64_t *starts, const char *pool, std::size_t count);
+
+    /**
+     * @brief Removes all names; model IDs start again at 0.
+     */
+    void Clear();
+
+    /// Number of distinct names.
+    std::size_t Size() const { return _names.size(); }
+
+    /// Characters of all names together.
+    std::size_t CharCount() const { return _arena.Size(); }
+
+    const std::vector<std::string_view> &Names() const { return _names; }
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Finds available cars by model name, or by the start of it.
+ *
+ * Model IDs come from the inventory's ModelDictionary, which stores every
+ * distinct model name once. For each model ID the index keeps the slots of
+ * the cars of that model that are still for sale (a "posting list"). The
+ * names are kept sorted, so a prefix like "Opel" or "Mercedes-Benz C" only
+ * visits the models that start with it, never the whole inventory. The
+ * sorted names are views into the dictionary, not copies, so the
+ * dictionary has to outlive the index (or its next Clear).
+ *
+ * Selling a car removes it from its posting list in constant time: the
+ * index remembers where each slot sits in its list, and the last entry of
+ * the list is moved into the hole.
+ */
+class ModelIndex
+{
+
+private:
+    std::map<std::string_view, std::uint32_t> _modelIds;          // sorted, for prefix search
+    std::vector<std::vector<std::size_t>> _available;             // per model ID: slots still for sale
+    std::vector<bool> _named;                                     // per model ID: its name is in _modelIds
+    std::vector<std::uint32_t> _slotModels;                       // per slot: its model ID
+    std::vector<std::size_t> _slotPositions;                      // per slot: index in its posting list, or npos if sold
+
+public:
+    /// Marks a slot that is not in any posting list (the car is sold).
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /**
+     * @brief Adds the car in the given slot.
+     *
+     * Slots have to be added in order (0, 1, 2, ...), the same way CarStore
+     * hands them out. The sorted names are only touched the first time a
+     * model ID shows up.
+     *
+     * @param slot The slot of the car in the inventory.
+     * @param modelId The model ID, like the one CarStore keeps for the car.
+     * @param model The model's name in the dictionary; kept as a view.
+     * @param sold Whether the car is already sold; sold cars are never returned by searches.
+     */
+    void Add(std::size_t slot, std::uint32_t modelId, std::string_view model, bool sold);
+
+    /**
+     * @brief Takes the car in the given slot out of the search results.
+     */
+    void MarkSold(std::size_t slot);
+
+    /**
+     * @brief Makes room for the given number of cars up front.
+     */
+    void Reserve(std::size_t carCount);
+
+    /**
+     * @brief Removes all cars and model names.
+     */
+    void Clear();
+
+    /**
+     * @brief Finds all available cars whose model name starts with the given text.
+     *
+     * An empty prefix matches every model. The search is case sensitive.
+     *
+     * @param prefix The start of the model name, like "Opel".
+     * @return The slots of the matching cars, in inventory order.
+     */
+    std::vector<std::size_t> FindAvailable(std::string_view prefix) const;
+
+    /**
+     * @brief Gets the model ID of the car in the given slot.
+     */
+    std::uint32_t GetModelId(std::size_t slot) const { return _slotModels[slot]; }
+
+    /**
+     * @brief Gets the number of distinct model names.
+     */
+    std::size_t GetModelCount() const { return _available.size(); }
+};
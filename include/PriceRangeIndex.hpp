@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Depreciation.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+class CarStore;
+
+/**
+ * @brief Finds the available cars whose current price lies in a range.
+ *
+ * Prices keep changing, but all cars added within the same second are at
+ * most one depreciation step apart, so they share (nearly) the same price
+ * multiplier. The index groups cars by the second they were added and keeps
+ * each group sorted by initial price; a price range then becomes a range
+ * of initial prices in every group, found with a binary search, and only
+ * the cars at its edges need their exact price checked.
+ *
+ * Groups whose cars are all capped (their price no longer changes) are
+ * merged into a few big sorted runs with the cap multiplier, merged like
+ * a binary counter so there are only logarithmically many. So a query
+ * looks at one group per second of the schedule's active window plus the
+ * capped runs, never at every car.
+ *
+ * Sold cars are skipped when found. MarkSold counts them per group (and for
+ * all capped runs together) and drops them once they make up half of it,
+ * so an inventory that is mostly sold does not leave a mostly dead index
+ * behind. The index starts over whenever the grouping would no longer be right (time
+ * went back, a new schedule, the inventory was replaced).
+ */
+class PriceRangeIndex
+{
+
+private:
+    struct Entry
+    {
+        double initialPrice;
+        std::size_t slot;
+
+        bool operator<(const Entry &other) const { return initialPrice < other.initialPrice; }
+    };
+
+    struct Group
+    {
+        std::vector<Entry> entries;
+        std::size_t sold = 0; // entries marked sold since the group was last compacted
+        bool sorted = true;
+    };
+
+    std::map<std::int64_t, Group> _stepping;    // by add time in whole seconds; cars still getting cheaper
+    std::vector<std::vector<Entry>> _capped; // sorted runs, each at most half the size of the one before
+    std::size_t _cappedSold = 0;             // sold entries still in _capped
+    std::chrono::system_clock::time_point _now;
+    bool _valid = false;
+
+    void Rebuild(const CarStore &store, const DepreciationPricer &pricer, std::chrono::system_clock::time_point currentTime);
+    void MoveCappedGroups(const CarStore &store, const DepreciationPricer &pricer);
+    void AddCappedRun(const CarStore &store, std::vector<Entry> run);
+    void DropSoldCapped(const CarStore &store);
+
+public:
+    /**
+     * @brief Adds a car just appended to the store.
+     *
+     * Does nothing while the index is invalid; the next Find picks the car up
+     * with everything else.
+     */
+    void Add(std::size_t slot, double initialPrice, std::chrono::system_clock::time_point addTime);
+
+    /**
+     * @brief Notes that a car was just marked sold in the store.
+     *
+     * Does nothing while the index is invalid.
+     */
+    void MarkSold(const CarStore &store, std::size_t slot);
+
+    /**
+     * @brief Finds the available cars priced between minPrice and maxPrice (both included).
+     *
+     * @param store The inventory the slots refer to.
+     * @param pricer The pricing rule the prices come from.
+     * @param minPrice The lowest price to include.
+     * @param maxPrice The highest price to include.
+     * @param currentTime The time the prices are taken at.
+     * @return The slots of the matching cars, in inventory order.
+     */
+    std::vector<std::size_t> Find(const CarStore &store, const DepreciationPricer &pricer, double minPrice, double maxPrice,
+                                  std::chrono::system_clock::time_point currentTime);
+
+    /**
+     * @brief Forgets every group; the next Find sorts the inventory in again.
+     */
+    void Invalidate();
+
+    /**
+     * @brief Gets the number of groups of cars whose price still changes.
+     */
+    std::size_t GetSteppingGroupCount() const { return _stepping.size(); }
+
+    /**
+     * @brief Gets the number of sorted runs of capped cars.
+     */
+    std::size_t GetCappedRunCount() const { return _capped.size(); }
+
+    /**
+     * @brief Gets the number of cars in the index, sold ones not yet dropped included.
+     */
+    std::size_t GetEntryCount() const;
+};
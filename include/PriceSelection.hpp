@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Depreciation.hpp"
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+class CarStore;
+
+/**
+ * @brief Which end of the price list SelectByPrice takes cars from.
+ */
+enum class PriceOrder
+{
+    Cheapest,
+    MostExpensive,
+};
+
+/**
+ * @brief One car picked by SelectByPrice, with the price it was picked for.
+ */
+struct PricedSlot
+{
+    std::size_t slot = 0;
+    double price = 0.0;
+};
+
+/**
+ * @brief Finds the k cheapest (or most expensive) available cars without sorting the inventory.
+ *
+ * The inventory is cut into pieces that are handled on their own threads.
+ * Each piece prices its cars in small batches and keeps only its best k in
+ * a bounded heap, so the work is linear in the inventory and the memory in
+ * k; at the end the pieces' heaps are merged and just those cars sorted.
+ * Small inventories are handled on the calling thread.
+ *
+ * @param store The inventory.
+ * @param pricer The pricing rule.
+ * @param k How many cars to return at most.
+ * @param currentTime The time the prices are taken at.
+ * @param order Whether to take the cheapest or the most expensive cars.
+ * @param threadCount How many threads to use at most; 0 means one per CPU core.
+ * @param minCarsPerThread Smallest piece worth giving its own thread.
+ * @return The cars in price order (cheapest or most expensive first); equal prices in slot order.
+ */
+std::vector<PricedSlot> SelectByPrice(const CarStore &store, const DepreciationPricer &pricer, std::size_t k,
+                                      std::chrono::system_clock::time_point currentTime, PriceOrder order,
+                                      unsigned int threadCount = 0, std::size_t minCarsPerThread = 1 << 16);
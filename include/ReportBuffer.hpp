@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <ios>
+#include <locale>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief A reusable text buffer for building whole reports before printing them.
+ *
+ * Numbers are formatted with std::to_chars, without going through a stream,
+ * and the finished text is handed to the output stream in one write. The
+ * memory is kept between reports, so after the first one building a report
+ * allocates nothing.
+ *
+ * Prices are formatted the way the target stream would format them (see
+ * UseFloatFormatOf), so the text is the same as if every value had been
+ * printed with operator<<. Fixed, scientific and default notation with any
+ * precision go through std::to_chars; anything else (showpoint, uppercase,
+ * showpos, hexfloat, a non-"C" locale) is rare enough to be handed to a
+ * stream set up like the target one.
+ */
+class ReportBuffer
+{
+
+private:
+    std::string _text;
+    std::ios_base::fmtflags _flags;
+    std::streamsize _precision;
+    std::locale _locale;
+    bool _useStream; // a format to_chars cannot produce
+
+    void AppendThroughStream(double value);
+
+public:
+    ReportBuffer() : _flags(std::ios_base::dec), _precision(6), _useStream(false){};
+
+    /**
+     * @brief Empties the buffer, keeping its memory for the next report.
+     */
+    void Clear() { _text.clear(); }
+
+    /**
+     * @brief Formats floating point numbers like the given stream currently does.
+     */
+    void UseFloatFormatOf(const std::ostream &out);
+
+    ReportBuffer &Append(std::string_view text)
+    {
+        _text.append(text.data(), text.size());
+        return *this;
+    }
+
+    ReportBuffer &Append(const ReportBuffer &other) { return Append(other.View()); }
+    ReportBuffer &Append(unsigned long long value);
+    ReportBuffer &Append(double value);
+
+    ReportBuffer &Append(unsigned int value) { return Append(static_cast<unsigned long long>(value)); }
+    ReportBuffer &Append(unsigned long value) { return Append(static_cast<unsigned long long>(value)); }
+
+    std::string_view View() const { return _text; }
+    std::size_t Size() const { return _text.size(); }
+
+    /**
+     * @brief Writes the whole buffer to the stream in one call and flushes it.
+     */
+    void WriteTo(std::ostream &out) const;
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Depreciation.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class CarStore;
+
+/**
+ * @brief Keeps the current price of every available car, updated only when it changes.
+ *
+ * A car's price only moves at its step boundaries (see Depreciation.hpp),
+ * so instead of pricing the whole inventory on every read the scheduler
+ * keeps each car's price together with the time of its next step in a
+ * min-heap. AdvanceTo pops just the cars whose step is due, reprices them
+ * and puts them back with their next step; cars at the cap are dropped from
+ * the heap for good. Once most cars are capped, advancing costs next to nothing.
+ *
+ * Sold cars are not removed right away; they fall out when their next
+ * step comes up. Whenever the cached prices cannot simply be moved forward
+ * (time went back, a new schedule, the inventory was replaced) the
+ * scheduler is invalidated and rebuilt with one batch pricing pass.
+ */
+class RepricingScheduler
+{
+
+private:
+    struct Due
+    {
+        std::chrono::system_clock::rep time; // when the car's next step starts
+        std::size_t slot;
+    };
+
+    // Orders the heap so the earliest step is on top.
+    struct Later
+    {
+        bool operator()(const Due &a, const Due &b) const { return a.time > b.time; }
+    };
+
+    std::vector<double> _prices; // per slot: price at _now
+    std::vector<Due> _queue;     // heap of the cars whose price will still change
+    std::chrono::system_clock::time_point _now;
+    bool _valid = false;
+
+    void Schedule(std::size_t slot, std::chrono::system_clock::time_point addTime, const DepreciationPricer &pricer);
+
+public:
+    /**
+     * @brief Starts tracking a car just appended to the store.
+     *
+     * Does nothing while the scheduler is invalid; the next AdvanceTo
+     * picks the car up with everything else.
+     */
+    void Add(std::size_t slot, double initialPrice, std::chrono::system_clock::time_point addTime,
+             const DepreciationPricer &pricer);
+
+    /**
+     * @brief Brings the cached prices of the available cars up to the given time.
+     *
+     * @return How many cars had to be repriced.
+     */
+    std::size_t AdvanceTo(const CarStore &store, const DepreciationPricer &pricer,
+                          std::chrono::system_clock::time_point currentTime);
+
+    /**
+     * @brief Forgets all cached prices; the next AdvanceTo prices every car again.
+     */
+    void Invalidate();
+
+    /**
+     * @brief Gets the cached price of a car, as of the last AdvanceTo.
+     */
+    double Price(std::size_t slot) const { return _prices[slot]; }
+
+    /**
+     * @brief Gets the cached price of every car, indexed by slot (stale for sold cars).
+     */
+    const std::vector<double> &Prices() const { return _prices; }
+
+    /**
+     * @brief Gets the number of cars whose price is still going to change.
+     */
+    std::size_t PendingCount() const { return _queue.size(); }
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Binary snapshot file format for the car inventory.
+ *
+ * A snapshot starts with a SnapshotHeader, followed by the inventory
+ * stored column by column, exactly like CarStore keeps it in memory:
+ *
+ *   ids            uint32 x count
+ *   registerYears  uint32 x count
+ *   initialPrices  double x count
+ *   addTimes       int64  x count (system_clock ticks)
+ *   salePrices     double x count
+ *   soldFlags      uint8  x count
+ *   modelIds       uint32 x count, indexes into the model dictionary
+ *   modelStarts    uint64 x (modelCount + 1), offsets into the string table
+ *   stringTable    every distinct model name once, back to back
+ *
+ * The last two sections are the inventory's ModelDictionary, so a model
+ * name is stored once however many cars have it.
+ *
+ * Every column is a fixed-width array padded to a multiple of 8 bytes,
+ * so loading is a handful of block copies with no per-record parsing.
+ * Numbers are stored in the machine's native byte order.
+ */
+namespace Snapshot
+{
+    constexpr char kMagic[8] = {'C', 'A', 'R', 'S', 'N', 'A', 'P', '\0'};
+    constexpr std::uint32_t kVersion = 2; // 2: model names are stored as a dictionary
+
+    struct Header
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t nextCarId;
+        std::uint64_t recordCount;
+        std::uint64_t modelCount;
+        std::uint64_t stringTableSize;
+        std::uint64_t payloadSize;   ///< Bytes after the header.
+        std::uint64_t checksum;      ///< Checksum of the payload.
+    };
+
+    /**
+     * @brief Rounds a section size up to the 8-byte alignment used in the file.
+     */
+    constexpr std::size_t Padded(std::size_t size) { return (size + 7) & ~std::size_t(7); }
+
+    /**
+     * @brief Forces a written file to disk (fsync).
+     *
+     * @return true if the file's contents are on disk.
+     */
+    bool SyncFile(const std::string &filename);
+
+    /**
+     * @brief Forces the directory entry of a file to disk, so a rename into it survives a power loss.
+     *
+     * Does nothing (and succeeds) on systems that cannot sync directories.
+     *
+     * @return true if the directory is on disk.
+     */
+    bool SyncParentDirectory(const std::string &filename);
+
+    /**
+     * @brief Incremental 64-bit checksum over 8-byte words.
+     *
+     * Data must be fed in pieces whose size is a multiple of 8
+     * (which every padded section is).
+     */
+    class Checksum
+    {
+
+    private:
+        std::uint64_t _hash;
+
+    public:
+        Checksum() : _hash(0xcbf29ce484222325ull){};
+
+        void Update(const void *data, std::size_t size);
+        std::uint64_t Value() const { return _hash; }
+    };
+}
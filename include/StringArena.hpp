@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Keeps many small strings in a few big blocks of memory.
+ *
+ * Storing a string just copies it behind the previous one in the current
+ * block (a "bump" allocation); a new block is only allocated when the
+ * current one is full. Blocks never move, so the returned string_views stay
+ * valid until Clear(), which frees all blocks at once.
+ */
+class StringArena
+{
+
+private:
+    std::vector<std::unique_ptr<char[]>> _blocks;
+    char *_cursor;
+    std::size_t _left;      // bytes still free in the current block
+    std::size_t _used;      // bytes handed out in total
+    std::size_t _allocated; // bytes in all blocks
+    std::size_t _blockSize;
+
+    void AddBlock(std::size_t size);
+
+public:
+    explicit StringArena(std::size_t blockSize = 64 * 1024)
+        : _cursor(nullptr), _left(0), _used(0), _allocated(0), _blockSize(blockSize > 0 ? blockSize : 1){};
+
+    StringArena(const StringArena &) = delete;
+    StringArena &operator=(const StringArena &) = delete;
+
+    /**
+     * @brief Copies a string into the arena.
+     *
+     * @return A view of the copy; valid until Clear().
+     */
+    std::string_view Store(std::string_view text);
+
+    /**
+     * @brief Makes sure the next strings with this many bytes in total fit without another allocation.
+     *
+     * Used before bulk loads, so a whole file's model names end up in one block.
+     */
+    void Reserve(std::size_t bytes);
+
+    /**
+     * @brief Frees every block; all views handed out so far become invalid.
+     */
+    void Clear();
+
+    /// Bytes of string data stored so far.
+    std::size_t Size() const { return _used; }
+
+    /// Bytes allocated for blocks, used or not.
+    std::size_t Capacity() const { return _allocated; }
+
+    std::size_t BlockCount() const { return _blocks.size(); }
+};
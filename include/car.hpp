@@ -1,8 +1,10 @@
 
 #pragma once
 
+#include "Clock.hpp"
 #include <string>
 #include <chrono>
+#include <cstddef>
 
 /**
 * @brief Holds all the details for a single used car.
@@ -37,11 +39,13 @@ public:
     * @param model The car's model name (like "Ford Focus").
     * @param registerYear The year it was first registered.
     * @param initialPrice The price we first listed the car at.
+    * @param clock Where the add time comes from; the system clock by default.
     */
-    Car(unsigned int id, const std::string &model, unsigned int year, double initialPrice)
+    Car(unsigned int id, const std::string &model, unsigned int year, double initialPrice,
+        const Clock &clock = DefaultClock())
         : _id(id), _model(model), _registerYear(year), _initialPrice(initialPrice), _isSold(false), _salePrice(0)
     {
-        _addTime = std::chrono::system_clock::now();
+        _addTime = clock.Now();
     }
 
     // Getters
@@ -72,6 +76,38 @@ public:
     */
     double CalculateCurrentPrice(std::chrono::system_clock::time_point currentTime) const;
 
+    /**
+    * @brief Calculates a depreciated price from raw values.
+    *
+    * Same rules as CalculateCurrentPrice, but works without a Car object,
+    * so other storage (like CarStore) can price its rows the same way.
+    *
+    * @param initialPrice The price the car was first listed at.
+    * @param addTime The time point when the car was added.
+    * @param currentTime The current system time point.
+    * @return The current calculated price.
+    */
+    static double CalculatePrice(double initialPrice, std::chrono::system_clock::time_point addTime,
+                                 std::chrono::system_clock::time_point currentTime);
+
+    /**
+    * @brief Calculates current prices for many cars in one pass.
+    *
+    * Gives exactly the same results as CalculatePrice for every car, but
+    * works on whole arrays without branches, so the compiler can turn it
+    * into SIMD code (an AVX2 version is picked at run time when the CPU
+    * supports it, with a plain version as fallback).
+    *
+    * @param addTimes When each car was added, as system_clock ticks since the epoch.
+    * @param initialPrices The listed price of each car.
+    * @param count How many cars there are.
+    * @param currentTime The current system time point.
+    * @param prices Receives the current price of each car.
+    */
+    static void CalculatePrices(const std::chrono::system_clock::rep *addTimes, const double *initialPrices,
+                                std::size_t count, std::chrono::system_clock::time_point currentTime,
+                                double *prices);
+
     /**
     * @brief Displays detailed information about the car to the console.
     *
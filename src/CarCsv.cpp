@@ -0,0 +1,168 @@
+#include "CarCsv.hpp"
+#include <algorithm>
+#include <charconv>
+#include <functional>
+#include <thread>
+
+namespace
+{
+    // Cuts the next ';'-separated field off the front of the text.
+    bool NextField(std::string_view &rest, std::string_view &field, bool &hasMore)
+    {
+        if (!hasMore)
+        {
+            return false;
+        }
+
+        std::size_t end = rest.find(';');
+        if (end == std::string_view::npos)
+        {
+            field = rest;
+            rest = std::string_view();
+            hasMore = false;
+        }
+        else
+        {
+            field = rest.substr(0, end);
+            rest.remove_prefix(end + 1);
+        }
+        return true;
+    }
+
+    std::string_view TrimNumber(std::string_view text)
+    {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t' || text.front() == '+'))
+        {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r'))
+        {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+
+    template <typename T>
+    bool ParseNumber(std::string_view text, T &value)
+    {
+        text = TrimNumber(text);
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return result.ec == std::errc();
+    }
+}
+
+const char *ParseCarLine(std::string_view line, CarRecord &record)
+{
+    std::string_view rest = line;
+    std::string_view field;
+    bool hasMore = true;
+    int isSold = 0;
+
+    if (!NextField(rest, field, hasMore) || line.empty())
+        return "Missing ID";
+    if (!ParseNumber(field, record.id))
+        return "Invalid ID";
+    if (!NextField(rest, field, hasMore))
+        return "Missing Model";
+    record.model = field;
+    if (!NextField(rest, field, hasMore))
+        return "Missing Register Year";
+    if (!ParseNumber(field, record.registerYear))
+        return "Invalid Register Year";
+    if (!NextField(rest, field, hasMore))
+        return "Missing Initial Price";
+    if (!ParseNumber(field, record.initialPrice))
+        return "Invalid Initial Price";
+    if (!NextField(rest, field, hasMore))
+        return "Missing IsSold status";
+    if (!ParseNumber(field, isSold))
+        return "Invalid IsSold status";
+    record.isSold = (isSold != 0);
+
+    // The sale price is everything that is left; a broken one just means 0.
+    record.salePrice = 0.0;
+    if (hasMore && !ParseNumber(rest, record.salePrice))
+    {
+        record.salePrice = 0.0;
+    }
+
+    return nullptr;
+}
+
+void ParseCarChunk(std::string_view text, CarCsvChunk &chunk)
+{
+    chunk.records.clear();
+    chunk.errors.clear();
+    chunk.lineCount = 0;
+    chunk.records.reserve(text.size() / 32);
+
+    while (!text.empty())
+    {
+        std::size_t end = text.find('\n');
+        std::string_view line = text.substr(0, end);
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+        chunk.lineCount++;
+
+        CarRecord record;
+        const char *error = ParseCarLine(line, record);
+
+        if (error != nullptr)
+        {
+            chunk.errors.push_back({chunk.lineCount, line, error});
+            continue;
+        }
+
+        chunk.records.push_back(record);
+    }
+}
+
+std::vector<CarCsvChunk> ParseCarCsv(std::string_view text, unsigned int threadCount,
+                                     std::size_t minBytesPerThread)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::size_t pieces = std::min<std::size_t>(threadCount, text.size() / std::max<std::size_t>(minBytesPerThread, 1));
+    pieces = std::max<std::size_t>(pieces, 1);
+
+    // Cut the text roughly evenly, moving every cut forward to just after a newline.
+    std::vector<std::string_view> parts;
+    std::size_t start = 0;
+    for (std::size_t i = 1; i <= pieces && start < text.size(); i++)
+    {
+        std::size_t end = text.size();
+        if (i < pieces)
+        {
+            end = text.find('\n', std::max(start, text.size() / pieces * i));
+            end = (end == std::string_view::npos) ? text.size() : end + 1;
+        }
+        parts.push_back(text.substr(start, end - start));
+        start = end;
+    }
+
+    std::vector<CarCsvChunk> chunks(parts.size());
+    if (parts.size() <= 1)
+    {
+        if (!parts.empty())
+        {
+            ParseCarChunk(parts[0], chunks[0]);
+        }
+        return chunks;
+    }
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < parts.size(); i++)
+    {
+        workers.emplace_back(ParseCarChunk, parts[i], std::ref(chunks[i]));
+    }
+    ParseCarChunk(parts[0], chunks[0]);
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    return chunks;
+}
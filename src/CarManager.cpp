@@ -1,132 +1,255 @@
 #include "CarManager.hpp"
+#include "CarCsv.hpp"
+#include "MappedFile.hpp"
+#include "Snapshot.hpp"
 #include <iostream>
 #include <chrono>
 #include <fstream>
 #include <iomanip>
-#include <stdexcept>
-#include <sstream>
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
 
-void CarManager::AddCar(const std::string &model, unsigned int registerYear, double initialPrice)
+namespace
 {
-    unsigned int newCarId = _nextCarId;
-    auto newCarPtr = std::make_unique<Car>(newCarId, model, registerYear, initialPrice);
+    static_assert(sizeof(unsigned int) == sizeof(std::uint32_t), "snapshot stores IDs and years as 32-bit values");
+    static_assert(sizeof(std::chrono::system_clock::rep) == sizeof(std::int64_t), "snapshot stores add times as 64-bit ticks");
 
-    std::cout << "Car added: ID " << newCarId << " (" << model << " " << registerYear << ") Initial Price: " << initialPrice << "\n";
+    // Writes one column followed by zero padding up to 8 bytes, and adds it to the checksum.
+    void WriteSection(std::ostream &out, Snapshot::Checksum &checksum, const void *data, std::size_t size)
+    {
+        // An empty column's data may be null, which memcpy and the checksum must not see.
+        std::size_t whole = size & ~std::size_t(7);
+        if (whole != 0)
+        {
+            out.write(static_cast<const char *>(data), whole);
+            checksum.Update(data, whole);
+        }
 
-    _cars.push_back(std::move(newCarPtr));
+        if (whole != size)
+        {
+            char tail[8] = {};
+            std::memcpy(tail, static_cast<const char *>(data) + whole, size - whole);
+            out.write(tail, sizeof(tail));
+            checksum.Update(tail, sizeof(tail));
+        }
+    }
+}
+
+unsigned int CarManager::AddCar(const std::string &model, unsigned int registerYear, double initialPrice)
+{
+    unsigned int newCarId = _nextCarId;
+    std::size_t slot = _store.Append(newCarId, model, registerYear, initialPrice, _clock->Now());
+
+    _idIndex.Insert(newCarId, slot);
+    _modelIndex.Add(slot, _store.GetModelId(slot), _store.GetModel(slot), false);
+    _repricing.Add(slot, initialPrice, _store.GetAddTime(slot), _depreciation);
+    _priceIndex.Add(slot, initialPrice, _store.GetAddTime(slot));
     _nextCarId++;
+
+    if (_journal)
+    {
+        _journal->AppendAdd(newCarId, model, registerYear, initialPrice, _store.AddTimes()[slot]);
+        CompactIfNeeded();
+    }
+
+    _events->CarAdded(newCarId, model, registerYear, initialPrice);
+    return newCarId;
 }
 
-bool CarManager::SellCar(unsigned int id)
+std::vector<unsigned int> CarManager::AddCars(const std::vector<CarSpec> &cars)
 {
-    auto currentTime = std::chrono::system_clock::now();
-    auto it = std::find_if(_cars.begin(), _cars.end(), [&](const std::unique_ptr<Car> &car)
-                           { return car->GetId() == id; });
+    std::vector<unsigned int> ids;
+    ids.reserve(cars.size());
+
+    // Reserve once for the whole batch, but never less than doubling, so
+    // many small batches still grow the columns geometrically.
+    std::size_t carCount = std::max(_store.Size() + cars.size(), 2 * _store.Size());
+    _store.Reserve(carCount);
+    _idIndex.Reserve(carCount);
+    _modelIndex.Reserve(carCount);
+
+    auto addTime = _clock->Now();
+    std::vector<JournalRecord> records;
+    if (_journal)
+    {
+        records.reserve(cars.size());
+    }
 
-    if (it != _cars.end())
+    for (const auto &car : cars)
     {
-        if ((*it)->IsSold())
+        unsigned int id = _nextCarId++;
+        std::size_t slot = _store.Append(id, car.model, car.registerYear, car.initialPrice, addTime);
+        _idIndex.Insert(id, slot);
+        _modelIndex.Add(slot, _store.GetModelId(slot), _store.GetModel(slot), false);
+        _repricing.Add(slot, car.initialPrice, addTime, _depreciation);
+        _priceIndex.Add(slot, car.initialPrice, addTime);
+        ids.push_back(id);
+        _events->CarAdded(id, car.model, car.registerYear, car.initialPrice);
+
+        if (_journal)
         {
-            std::cout << "Car already sold!!\n";
-            return false;
+            JournalRecord record;
+            record.type = JournalRecord::Type::Add;
+            record.id = id;
+            record.registerYear = car.registerYear;
+            record.initialPrice = car.initialPrice;
+            record.addTime = _store.AddTimes()[slot];
+            record.model = car.model;
+            records.push_back(record);
         }
+    }
 
-        (*it)->SetSold();
+    if (_journal)
+    {
+        _journal->AppendRecords(records);
+        CompactIfNeeded();
+    }
 
-        double actualSalePrice = (*it)->CalculateCurrentPrice(currentTime);
-        (*it)->SetSalePrice(actualSalePrice);
+    return ids;
+}
 
-        std::cout << "Success: Car with ID " << id << " (" << (*it)->GetModel()
-                  << ") sold for " << std::fixed << std::setprecision(2) << actualSalePrice << "." << std::endl;
+std::size_t CarManager::TrySell(std::chrono::system_clock::time_point currentTime, SaleResult &result)
+{
+    std::size_t slot = _idIndex.Find(result.id);
 
-        return true;
+    if (slot == IdIndex::npos)
+    {
+        result.status = SaleStatus::NotFound;
+        return slot;
     }
-    else
+    if (_store.IsSold(slot))
     {
-        std::cout << "Wrong Car ID\n";
+        result.status = SaleStatus::AlreadySold;
+        return slot;
     }
 
-    return false;
+    result.salePrice = _depreciation.Price(_store.GetInitialPrice(slot), _store.GetAddTime(slot), currentTime);
+    result.status = SaleStatus::Sold;
+    _store.MarkSold(slot, result.salePrice);
+    _modelIndex.MarkSold(slot);
+    _priceIndex.MarkSold(_store, slot);
+    return slot;
+}
+
+SaleResult CarManager::Sell(unsigned int id)
+{
+    SaleResult result;
+    result.id = id;
+    std::size_t slot = TrySell(_clock->Now(), result);
+
+    if (result.status == SaleStatus::Sold && _journal)
+    {
+        _journal->AppendSell(id, result.salePrice);
+        CompactIfNeeded();
+    }
+
+    _events->SaleAttempted(result, slot != IdIndex::npos ? _store.GetModel(slot) : std::string_view());
+    return result;
+}
+
+bool CarManager::SellCar(unsigned int id)
+{
+    return Sell(id).status == SaleStatus::Sold;
+}
+
+std::vector<SaleResult> CarManager::SellCars(const std::vector<unsigned int> &ids)
+{
+    std::vector<SaleResult> results;
+    results.reserve(ids.size());
+
+    auto currentTime = _clock->Now();
+    std::vector<JournalRecord> records;
+
+    for (unsigned int id : ids)
+    {
+        SaleResult result;
+        result.id = id;
+        std::size_t slot = TrySell(currentTime, result);
+        results.push_back(result);
+
+        _events->SaleAttempted(result, slot != IdIndex::npos ? _store.GetModel(slot) : std::string_view());
+
+        if (_journal && result.status == SaleStatus::Sold)
+        {
+            JournalRecord record;
+            record.type = JournalRecord::Type::Sell;
+            record.id = id;
+            record.salePrice = result.salePrice;
+            records.push_back(record);
+        }
+    }
+
+    if (_journal)
+    {
+        _journal->AppendRecords(records);
+        CompactIfNeeded();
+    }
+
+    return results;
 }
 
 void CarManager::LoadFromFile(const std::string &filename)
 {
-    std::ifstream inFile(filename);
+    MappedFile inFile;
 
-    if (!inFile.is_open())
+    if (!inFile.Open(filename))
     {
-        std::cout << "Warning: Could not open file for loading: " << filename << "." << std::endl;
-        _cars.clear();
-        _nextCarId = 1;
+        // Keep the inventory as it is, so memory still matches the snapshot and journal on disk.
+        _events->Message(EventLevel::Warning, "Could not open file for loading: " + filename + ".");
         return;
     }
 
-    _cars.clear();
+    _store.Clear();
+    _idIndex.Clear();
+    _modelIndex.Clear();
+    _repricing.Invalidate();
+    _priceIndex.Invalidate();
     _nextCarId = 1;
 
-    std::string line;
-    unsigned int maxId = 0;
+    // Parse on all cores, then add the pieces in file order so the result
+    // (slots, which duplicate ID wins, error order) matches a serial load.
+    std::vector<CarCsvChunk> chunks = ParseCarCsv(inFile.Data());
 
-    while (std::getline(inFile, line))
+    std::size_t recordCount = 0;
+    for (const auto &chunk : chunks)
     {
-        std::stringstream ss(line);
-        std::string segment;
+        recordCount += chunk.records.size();
+    }
+    _store.Reserve(recordCount);
+    _idIndex.Reserve(recordCount);
+    _modelIndex.Reserve(recordCount);
 
-        unsigned int id;
-        std::string model;
-        unsigned int registerYear;
-        double initialPrice;
-        bool isSold;
-        double salePrice = 0.0;
+    auto addTime = _clock->Now();
+    unsigned int maxId = 0;
+    std::size_t firstLine = 0;
 
-        try
+    for (const auto &chunk : chunks)
+    {
+        for (const auto &error : chunk.errors)
         {
-            if (!std::getline(ss, segment, ';'))
-                throw std::runtime_error("Missing ID");
-            id = std::stoul(segment);
-            if (!std::getline(ss, segment, ';'))
-                throw std::runtime_error("Missing Model");
-            model = segment;
-            if (!std::getline(ss, segment, ';'))
-                throw std::runtime_error("Missing Register Year");
-            registerYear = std::stoul(segment);
-            if (!std::getline(ss, segment, ';'))
-                throw std::runtime_error("Missing Initial Price");
-            initialPrice = std::stod(segment);
-            if (!std::getline(ss, segment, ';'))
-                throw std::runtime_error("Missing IsSold status");
-            isSold = (std::stoi(segment) != 0);
-            if (std::getline(ss, segment) && !segment.empty())
-            {
-                try
-                {
-                    salePrice = std::stod(segment);
-                }
-                catch (const std::exception &e)
-                {
-                }
-            }
+            _events->LineSkipped(firstLine + error.lineNumber, error.line, error.message);
+        }
 
-            auto car_ptr = std::make_unique<Car>(id, model, registerYear, initialPrice);
+        for (const auto &record : chunk.records)
+        {
+            std::size_t slot = _store.Append(record.id, record.model, record.registerYear, record.initialPrice, addTime);
 
-            if (isSold)
+            if (record.isSold)
             {
-                car_ptr->SetSold();
-                car_ptr->SetSalePrice(salePrice);
+                _store.MarkSold(slot, record.salePrice);
             }
 
-            _cars.push_back(std::move(car_ptr));
+            _idIndex.Insert(record.id, slot);
+            _modelIndex.Add(slot, _store.GetModelId(slot), _store.GetModel(slot), record.isSold);
 
-            if (id >= maxId)
+            if (record.id >= maxId)
             {
-                maxId = id;
+                maxId = record.id;
             }
         }
-        catch (const std::exception &e)
-        {
-            std::cerr << "Error parsing line: '" << line << "'. Error: " << e.what() << ". Skipping line." << std::endl;
-        }
+
+        firstLine += chunk.lineCount;
     }
 
     if (maxId > 0)
@@ -138,7 +261,9 @@ void CarManager::LoadFromFile(const std::string &filename)
         _nextCarId = 1;
     }
 
-    std::cout << "Cars successfully loaded from " << filename << ". Total cars: " << _cars.size() << std::endl;
+    _events->Message(EventLevel::Info, "Cars successfully loaded from " + filename + ". Total cars: " + std::to_string(_store.Size()));
+
+    CompactJournal();
 }
 
 void CarManager::SaveToFile(const std::string &filename) const
@@ -147,90 +272,181 @@ void CarManager::SaveToFile(const std::string &filename) const
 
     if (!outFile.is_open())
     {
-        std::cerr << "Error: Could not open file for saving: " << filename << std::endl;
+        _events->Message(EventLevel::Error, "Could not open file for saving: " + filename);
         return;
     }
 
     outFile << std::fixed << std::setprecision(2);
 
-    for (const auto &car_ptr : _cars)
+    for (std::size_t slot = 0; slot < _store.Size(); slot++)
     {
-        const Car *car = car_ptr.get();
-
-        outFile << car->GetId() << ";";
-        outFile << car->GetModel() << ";";
-        outFile << car->GetRegisterYear() << ";";
-        outFile << car->GetInitialPrice() << ";";
-        outFile << car->IsSold() << ";";
-        outFile << car->GetSalePrice() << "\n";
+        CarView car = _store[slot];
+
+        outFile << car.GetId() << ";";
+        outFile << car.GetModel() << ";";
+        outFile << car.GetRegisterYear() << ";";
+        outFile << car.GetInitialPrice() << ";";
+        outFile << car.IsSold() << ";";
+        outFile << car.GetSalePrice() << "\n";
     }
 
-    std::cout << "Inventory successfully saved to " << filename << std::endl;
+    _events->Message(EventLevel::Info, "Inventory successfully saved to " + filename);
 }
 
 void CarManager::ShowAvailableCars() const
 {
-    std::cout << "--- Available Cars ---\n";
-    auto currentTime = std::chrono::system_clock::now();
-    bool foundAvailable = false;
+    ShowAvailableCars(std::cout);
+}
 
-    for (auto &&car_ptr : _cars)
+void CarManager::ShowAvailableCars(std::ostream &out) const
+{
+    _report.Clear();
+    _report.UseFloatFormatOf(out);
+    _report.Append("--- Available Cars ---\n");
+    // Only the cars whose price stepped since the last read are priced again.
+    _repricing.AdvanceTo(_store, _depreciation, _clock->Now());
+    const std::vector<double> &prices = _repricing.Prices();
+
+    _store.ForEachAvailable([&](std::size_t slot)
+                            {
+                                _report.Append("ID: ").Append(_store.GetId(slot));
+                                _report.Append("\nModel: ").Append(_store.GetModel(slot));
+                                _report.Append("\nRegister Year: ").Append(_store.GetRegisterYear(slot));
+                                _report.Append("\nActual Price: ").Append(prices[slot]);
+                                _report.Append("\nStatus: Available\n");
+                                _report.Append("----------------------\n"); });
+
+    if (_store.AvailableCount() == 0)
     {
-        if (!car_ptr->IsSold())
-        {
-            car_ptr->ShowCarInfo(currentTime);
-            std::cout << "----------------------\n";
-            foundAvailable = true;
-        }
+        _report.Append("No cars currently available for sale.\n");
     }
+    _report.WriteTo(out);
+}
 
-    if (!foundAvailable)
+std::vector<unsigned int> CarManager::FindAvailableByModel(const std::string &modelPrefix) const
+{
+    std::vector<unsigned int> ids;
+
+    for (std::size_t slot : _modelIndex.FindAvailable(modelPrefix))
     {
-        std::cout << "No cars currently available for sale.\n";
+        ids.push_back(_store.GetId(slot));
     }
+    return ids;
 }
 
-void CarManager::ShowDailyReport() const
+std::vector<unsigned int> CarManager::FindAvailableByPrice(double minPrice, double maxPrice) const
 {
-    int soldCounter = 0;
-    int notSoldCounter = 0;
+    std::vector<unsigned int> ids;
 
-    std::cout << "----------- Day Report ---------\n";
-    std::cout << "----------- Sold Cars ---------\n";
+    for (std::size_t slot : _priceIndex.Find(_store, _depreciation, minPrice, maxPrice, _clock->Now()))
+    {
+        ids.push_back(_store.GetId(slot));
+    }
+    return ids;
+}
 
-    for (auto &&car_ptr : _cars)
+namespace
+{
+    std::vector<PricedCar> ToPricedCars(const CarStore &store, const std::vector<PricedSlot> &slots)
     {
-        if (car_ptr->IsSold())
+        std::vector<PricedCar> cars;
+        cars.reserve(slots.size());
+        for (const PricedSlot &car : slots)
         {
-            car_ptr->ShowCarInfo();
-            std::cout << "----------------------\n";
-            soldCounter++;
+            cars.push_back({store.GetId(car.slot), car.price});
         }
+        return cars;
     }
+}
+
+std::vector<PricedCar> CarManager::TopKCheapestAvailable(std::size_t k, std::chrono::system_clock::time_point currentTime) const
+{
+    return ToPricedCars(_store, SelectByPrice(_store, _depreciation, k, currentTime, PriceOrder::Cheapest));
+}
+
+std::vector<PricedCar> CarManager::TopKMostExpensive(std::size_t k, std::chrono::system_clock::time_point currentTime) const
+{
+    return ToPricedCars(_store, SelectByPrice(_store, _depreciation, k, currentTime, PriceOrder::MostExpensive));
+}
 
-    std::cout << "----------- Not Sold Cars ---------\n";
-    for (auto &&car_ptr : _cars)
+void CarManager::ShowAvailableCarsByModel(const std::string &modelPrefix) const
+{
+    ShowAvailableCarsByModel(std::cout, modelPrefix);
+}
+
+void CarManager::ShowAvailableCarsByModel(std::ostream &out, const std::string &modelPrefix) const
+{
+    _report.Clear();
+    _report.UseFloatFormatOf(out);
+    _report.Append("--- Available Cars: ").Append(modelPrefix).Append(" ---\n");
+    _repricing.AdvanceTo(_store, _depreciation, _clock->Now());
+    std::vector<std::size_t> slots = _modelIndex.FindAvailable(modelPrefix);
+
+    for (std::size_t slot : slots)
     {
-        if (!car_ptr->IsSold())
-        {
-            car_ptr->ShowCarInfo();
-            std::cout << "----------------------\n";
-            notSoldCounter++;
-        }
+        _report.Append("ID: ").Append(_store.GetId(slot));
+        _report.Append("\nModel: ").Append(_store.GetModel(slot));
+        _report.Append("\nRegister Year: ").Append(_store.GetRegisterYear(slot));
+        _report.Append("\nActual Price: ").Append(_repricing.Price(slot));
+        _report.Append("\nStatus: Available\n");
+        _report.Append("----------------------\n");
+    }
+
+    if (slots.empty())
+    {
+        _report.Append("No available cars match \"").Append(modelPrefix).Append("\".\n");
+    }
+    _report.WriteTo(out);
+}
+
+void CarManager::ShowDailyReport() const
+{
+    ShowDailyReport(std::cout);
+}
+
+void CarManager::ShowDailyReport(std::ostream &out) const
+{
+    _report.Clear();
+    _reportAvailable.Clear();
+    _report.UseFloatFormatOf(out);
+    _reportAvailable.UseFloatFormatOf(out);
+
+    _report.Append("----------- Day Report ---------\n");
+    _report.Append("----------- Sold Cars ---------\n");
+
+    // One pass over the inventory; available cars go to their own buffer
+    // and are appended after the sold ones.
+    for (std::size_t slot = 0; slot < _store.Size(); slot++)
+    {
+        bool sold = _store.IsSold(slot);
+        ReportBuffer &part = sold ? _report : _reportAvailable;
+
+        part.Append("ID: ").Append(_store.GetId(slot));
+        part.Append("\nModel: ").Append(_store.GetModel(slot));
+        part.Append("\nRegister Year: ").Append(_store.GetRegisterYear(slot));
+        part.Append("\nSell Price: ").Append(_store.GetInitialPrice(slot));
+        part.Append(sold ? "\nStatus: Sold\n" : "\nStatus: Available\n");
+        part.Append("----------------------\n");
     }
 
-    std::cout << "Summary: Sold - " << soldCounter << ", Available - " << notSoldCounter << "\n"; // Ulepszone formatowanie i literówka
-    std::cout << "----------------------------------\n";
+    _report.Append("----------- Not Sold Cars ---------\n");
+    _report.Append(_reportAvailable);
+    // Counts come from the running statistics, not from the pass above.
+    InventoryStatistics statistics = GetStatistics();
+    _report.Append("Summary: Sold - ").Append(statistics.soldCount);
+    _report.Append(", Available - ").Append(statistics.availableCount).Append("\n");
+    _report.Append("----------------------------------\n");
+
+    _report.WriteTo(out);
 }
 
 bool CarManager::IsCarSold(unsigned int id) const
 {
-    auto it = std::find_if(_cars.begin(), _cars.end(), [&](const std::unique_ptr<Car> &car_ptr)
-                           { return car_ptr->GetId() == id; });
+    std::size_t slot = _idIndex.Find(id);
 
-    if (it != _cars.end())
+    if (slot != IdIndex::npos)
     {
-        return (*it)->IsSold();
+        return _store.IsSold(slot);
     }
 
     return false;
@@ -238,10 +454,336 @@ bool CarManager::IsCarSold(unsigned int id) const
 
 int CarManager::GetCarCount() const
 {
-    return _cars.size();
+    return _store.Size();
+}
+
+std::size_t CarManager::GetAvailableCount() const
+{
+    return _store.AvailableCount();
+}
+
+std::size_t CarManager::GetSoldCount() const
+{
+    return _store.SoldCount();
+}
+
+InventoryStatistics CarManager::GetStatistics() const
+{
+    InventoryStatistics statistics;
+    statistics.soldCount = _store.SoldCount();
+    statistics.availableCount = _store.AvailableCount();
+    statistics.totalRevenue = _store.Revenue();
+    statistics.totalListedValue = _store.AvailableInitialValue();
+    statistics.totalDiscount = _store.SoldInitialValue() - _store.Revenue();
+    return statistics;
 }
 
 int CarManager::GetNextCarId() const
 {
     return _nextCarId;
 }
+
+bool CarManager::SaveSnapshot(const std::string &filename) const
+{
+    // Write next to the target and rename at the end, so a crash never leaves half a snapshot.
+    const std::string tempFilename = filename + ".tmp";
+    std::ofstream outFile(tempFilename, std::ios::binary | std::ios::trunc);
+
+    if (!outFile.is_open())
+    {
+        _events->Message(EventLevel::Error, "Could not open file for saving: " + filename);
+        return false;
+    }
+
+    const std::size_t count = _store.Size();
+    const ModelDictionary &models = _store.Models();
+
+    // The dictionary's names live in arena blocks; the file wants them as one string table.
+    std::string modelPool;
+    std::vector<std::uint64_t> modelStarts;
+    modelPool.reserve(models.CharCount());
+    modelStarts.reserve(models.Size() + 1);
+    modelStarts.push_back(0);
+    for (std::string_view model : models.Names())
+    {
+        modelPool.append(model.data(), model.size());
+        modelStarts.push_back(modelPool.size());
+    }
+
+    Snapshot::Header header = {};
+    std::memcpy(header.magic, Snapshot::kMagic, sizeof(header.magic));
+    header.version = Snapshot::kVersion;
+    header.nextCarId = _nextCarId;
+    header.recordCount = count;
+    header.modelCount = models.Size();
+    header.stringTableSize = modelPool.size();
+
+    // Header first as a placeholder; the checksum is only known at the end.
+    outFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    Snapshot::Checksum checksum;
+    WriteSection(outFile, checksum, _store.Ids().data(), count * sizeof(std::uint32_t));
+    WriteSection(outFile, checksum, _store.RegisterYears().data(), count * sizeof(std::uint32_t));
+    WriteSection(outFile, checksum, _store.InitialPrices().data(), count * sizeof(double));
+    WriteSection(outFile, checksum, _store.AddTimes().data(), count * sizeof(std::int64_t));
+    WriteSection(outFile, checksum, _store.SalePrices().data(), count * sizeof(double));
+    std::vector<std::uint8_t> soldFlags(count, 0);
+    _store.ForEachSold([&](std::size_t slot)
+                       { soldFlags[slot] = 1; });
+    WriteSection(outFile, checksum, soldFlags.data(), count * sizeof(std::uint8_t));
+
+    WriteSection(outFile, checksum, _store.ModelIds().data(), count * sizeof(std::uint32_t));
+    WriteSection(outFile, checksum, modelStarts.data(), modelStarts.size() * sizeof(std::uint64_t));
+
+    WriteSection(outFile, checksum, modelPool.data(), modelPool.size());
+
+    header.payloadSize = static_cast<std::uint64_t>(outFile.tellp()) - sizeof(header);
+    header.checksum = checksum.Value();
+    outFile.seekp(0);
+    outFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    outFile.close();
+
+    // The data has to be on disk before the rename makes it the snapshot;
+    // otherwise a power loss can leave an empty file under the real name.
+    if (!outFile || !Snapshot::SyncFile(tempFilename))
+    {
+        _events->Message(EventLevel::Error, "Could not write snapshot: " + filename);
+        std::remove(tempFilename.c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    std::remove(filename.c_str());
+#endif
+    if (std::rename(tempFilename.c_str(), filename.c_str()) != 0)
+    {
+        _events->Message(EventLevel::Error, "Could not replace snapshot: " + filename);
+        std::remove(tempFilename.c_str());
+        return false;
+    }
+
+    // And the rename itself has to be on disk before anyone drops the journal.
+    if (!Snapshot::SyncParentDirectory(filename))
+    {
+        _events->Message(EventLevel::Error, "Could not sync the directory of snapshot: " + filename);
+        return false;
+    }
+
+    _events->Message(EventLevel::Info, "Snapshot successfully saved to " + filename);
+    return true;
+}
+
+bool CarManager::LoadSnapshot(const std::string &filename)
+{
+    MappedFile inFile;
+
+    if (!inFile.Open(filename))
+    {
+        return false;
+    }
+
+    const char *data = inFile.Data().data();
+    Snapshot::Header header;
+
+    if (inFile.Size() < sizeof(header))
+    {
+        _events->Message(EventLevel::Error, "Snapshot is too small: " + filename);
+        return false;
+    }
+
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, Snapshot::kMagic, sizeof(header.magic)) != 0 || header.version != Snapshot::kVersion)
+    {
+        _events->Message(EventLevel::Error, "Unsupported snapshot format: " + filename);
+        return false;
+    }
+
+    if (header.recordCount > inFile.Size() || header.modelCount > inFile.Size() || header.stringTableSize > inFile.Size())
+    {
+        _events->Message(EventLevel::Error, "Snapshot is truncated or damaged: " + filename);
+        return false;
+    }
+
+    const std::size_t count = header.recordCount;
+    const std::size_t modelCount = header.modelCount;
+    std::size_t offsets[9];
+    std::size_t position = sizeof(header);
+    const std::size_t sizes[9] = {
+        count * sizeof(std::uint32_t),
+        count * sizeof(std::uint32_t),
+        count * sizeof(double),
+        count * sizeof(std::int64_t),
+        count * sizeof(double),
+        count * sizeof(std::uint8_t),
+        count * sizeof(std::uint32_t),
+        (modelCount + 1) * sizeof(std::uint64_t),
+        header.stringTableSize,
+    };
+
+    for (int i = 0; i < 9; i++)
+    {
+        offsets[i] = position;
+        position += Snapshot::Padded(sizes[i]);
+    }
+
+    if (header.payloadSize != position - sizeof(header) || inFile.Size() != position)
+    {
+        _events->Message(EventLevel::Error, "Snapshot is truncated or damaged: " + filename);
+        return false;
+    }
+
+    Snapshot::Checksum checksum;
+    checksum.Update(data + sizeof(header), header.payloadSize);
+
+    if (checksum.Value() != header.checksum)
+    {
+        _events->Message(EventLevel::Error, "Snapshot checksum mismatch: " + filename);
+        return false;
+    }
+
+    CarColumns columns;
+    columns.count = count;
+    columns.ids = reinterpret_cast<const std::uint32_t *>(data + offsets[0]);
+    columns.registerYears = reinterpret_cast<const std::uint32_t *>(data + offsets[1]);
+    columns.initialPrices = reinterpret_cast<const double *>(data + offsets[2]);
+    columns.addTimes = reinterpret_cast<const std::int64_t *>(data + offsets[3]);
+    columns.salePrices = reinterpret_cast<const double *>(data + offsets[4]);
+    columns.soldFlags = reinterpret_cast<const std::uint8_t *>(data + offsets[5]);
+    columns.modelIds = reinterpret_cast<const std::uint32_t *>(data + offsets[6]);
+    columns.modelCount = modelCount;
+    columns.modelStarts = reinterpret_cast<const std::uint64_t *>(data + offsets[7]);
+    columns.modelPool = data + offsets[8];
+    columns.modelPoolSize = header.stringTableSize;
+
+    bool modelsValid = columns.modelStarts[0] == 0 && columns.modelStarts[modelCount] == header.stringTableSize;
+    for (std::size_t model = 0; modelsValid && model < modelCount; model++)
+    {
+        modelsValid = columns.modelStarts[model] <= columns.modelStarts[model + 1];
+    }
+    for (std::size_t slot = 0; modelsValid && slot < count; slot++)
+    {
+        modelsValid = columns.modelIds[slot] < modelCount;
+    }
+
+    if (!modelsValid)
+    {
+        _events->Message(EventLevel::Error, "Snapshot string table is damaged: " + filename);
+        return false;
+    }
+
+    _store.Assign(columns);
+    _idIndex.Clear();
+    _idIndex.Reserve(count);
+    _modelIndex.Clear();
+    _modelIndex.Reserve(count);
+    _repricing.Invalidate();
+    _priceIndex.Invalidate();
+
+    for (std::size_t slot = 0; slot < count; slot++)
+    {
+        _idIndex.Insert(columns.ids[slot], slot);
+        _modelIndex.Add(slot, _store.GetModelId(slot), _store.GetModel(slot), _store.IsSold(slot));
+    }
+
+    _nextCarId = header.nextCarId;
+
+    _events->Message(EventLevel::Info, "Snapshot successfully loaded from " + filename + ". Total cars: " + std::to_string(_store.Size()));
+    return true;
+}
+
+bool CarManager::OpenJournal(const std::string &snapshotFilename, const std::string &journalFilename)
+{
+    _journal.reset();
+    _snapshotFilename = snapshotFilename;
+
+    bool restored = LoadSnapshot(snapshotFilename);
+
+    auto journal = std::make_unique<Journal>();
+    journal->SetMessageHandler([this](EventLevel level, const std::string &text)
+                               { _events->Message(level, text); });
+    if (!journal->Open(journalFilename, [this](const JournalRecord &record)
+                       { ApplyJournalRecord(record); }))
+    {
+        return restored;
+    }
+
+    if (journal->GetRecordCount() > 0)
+    {
+        _events->Message(EventLevel::Info, "Replayed " + std::to_string(journal->GetRecordCount()) + " journaled changes from " + journalFilename);
+        restored = true;
+    }
+
+    _journal = std::move(journal);
+    return restored;
+}
+
+void CarManager::ApplyJournalRecord(const JournalRecord &record)
+{
+    std::size_t slot = _idIndex.Find(record.id);
+
+    if (record.type == JournalRecord::Type::Add)
+    {
+        if (slot != IdIndex::npos)
+        {
+            return; // already in the snapshot
+        }
+
+        auto addTime = std::chrono::system_clock::time_point(std::chrono::system_clock::duration(record.addTime));
+        slot = _store.Append(record.id, record.model, record.registerYear, record.initialPrice, addTime);
+        _idIndex.Insert(record.id, slot);
+        _modelIndex.Add(slot, _store.GetModelId(slot), _store.GetModel(slot), false);
+        _repricing.Add(slot, record.initialPrice, addTime, _depreciation);
+        _priceIndex.Add(slot, record.initialPrice, addTime);
+
+        if (record.id >= _nextCarId)
+        {
+            _nextCarId = record.id + 1;
+        }
+    }
+    else if (record.type == JournalRecord::Type::Sell)
+    {
+        if (slot != IdIndex::npos && !_store.IsSold(slot))
+        {
+            _store.MarkSold(slot, record.salePrice);
+            _modelIndex.MarkSold(slot);
+            _priceIndex.MarkSold(_store, slot);
+        }
+    }
+}
+
+void CarManager::CompactJournal()
+{
+    if (!_journal)
+    {
+        return;
+    }
+
+    // A journal that cannot reach the disk must not be replaced by a snapshot
+    // built on top of it; the error was already reported.
+    if (!_journal->Sync())
+    {
+        return;
+    }
+
+    // Only forget the journaled changes once the snapshot and its rename are
+    // on disk (SaveSnapshot syncs both).
+    if (SaveSnapshot(_snapshotFilename))
+    {
+        _journal->Truncate();
+    }
+}
+
+bool CarManager::SyncJournal()
+{
+    return !_journal || _journal->Sync();
+}
+
+void CarManager::CompactIfNeeded()
+{
+    if (_journal && _journal->GetRecordCount() >= _compactAfter)
+    {
+        CompactJournal();
+    }
+}
@@ -0,0 +1,142 @@
+#include "CarStore.hpp"
+#include "car.hpp"
+#include <algorithm>
+#include <iostream>
+
+std::size_t CarStore::Append(unsigned int id, std::string_view model, unsigned int registerYear,
+                             double initialPrice, std::chrono::system_clock::time_point addTime)
+{
+    std::size_t slot = _ids.size();
+
+    _ids.push_back(id);
+    _registerYears.push_back(registerYear);
+    _initialPrices.push_back(initialPrice);
+    _addTimes.push_back(addTime.time_since_epoch().count());
+    if (slot % 64 == 0)
+    {
+        _soldBits.push_back(0);
+    }
+    _salePrices.push_back(0.0);
+    _availableInitialValue += initialPrice;
+
+    _modelIds.push_back(_dictionary.Intern(model));
+
+    return slot;
+}
+
+void CarStore::MarkSold(std::size_t slot, double salePrice)
+{
+    std::uint64_t bit = std::uint64_t(1) << (slot % 64);
+    if ((_soldBits[slot / 64] & bit) == 0)
+    {
+        _soldBits[slot / 64] |= bit;
+        _soldCount++;
+        _soldInitialValue += _initialPrices[slot];
+        _revenue += salePrice;
+
+        // Subtracting leaves rounding residue behind; with nothing left for sale the value is exactly 0.
+        _availableInitialValue = AvailableCount() == 0 ? 0.0 : std::max(0.0, _availableInitialValue - _initialPrices[slot]);
+    }
+    else
+    {
+        _revenue += salePrice - _salePrices[slot];
+    }
+    _salePrices[slot] = salePrice;
+}
+
+void CarStore::Reserve(std::size_t carCount)
+{
+    _ids.reserve(carCount);
+    _registerYears.reserve(carCount);
+    _initialPrices.reserve(carCount);
+    _addTimes.reserve(carCount);
+    _soldBits.reserve((carCount + 63) / 64);
+    _salePrices.reserve(carCount);
+    _modelIds.reserve(carCount);
+}
+
+void CarStore::Clear()
+{
+    _ids.clear();
+    _registerYears.clear();
+    _initialPrices.clear();
+    _addTimes.clear();
+    _soldBits.clear();
+    _soldCount = 0;
+    _availableInitialValue = 0.0;
+    _soldInitialValue = 0.0;
+    _revenue = 0.0;
+    _salePrices.clear();
+    _modelIds.clear();
+    _dictionary.Clear();
+}
+
+void CarStore::Assign(const CarColumns &columns)
+{
+    const std::size_t n = columns.count;
+
+    _ids.assign(columns.ids, columns.ids + n);
+    _registerYears.assign(columns.registerYears, columns.registerYears + n);
+    _initialPrices.assign(columns.initialPrices, columns.initialPrices + n);
+    _addTimes.assign(columns.addTimes, columns.addTimes + n);
+    _soldBits.assign((n + 63) / 64, 0);
+    for (std::size_t slot = 0; slot < n; slot++)
+    {
+        _soldBits[slot / 64] |= std::uint64_t(columns.soldFlags[slot] != 0) << (slot % 64);
+    }
+    _soldCount = 0;
+    for (std::uint64_t word : _soldBits)
+    {
+        _soldCount += CountSetBits(word);
+    }
+
+    _salePrices.assign(columns.salePrices, columns.salePrices + n);
+    _modelIds.assign(columns.modelIds, columns.modelIds + n);
+    _dictionary.Assign(columns.modelStarts, columns.modelPool, columns.modelCount);
+
+    _availableInitialValue = 0.0;
+    _soldInitialValue = 0.0;
+    _revenue = 0.0;
+    ForEachAvailable([&](std::size_t slot)
+                     { _availableInitialValue += _initialPrices[slot]; });
+    ForEachSold([&](std::size_t slot)
+                {
+                    _soldInitialValue += _initialPrices[slot];
+                    _revenue += _salePrices[slot]; });
+}
+
+unsigned int CarView::GetId() const { return _store->GetId(_slot); }
+std::string_view CarView::GetModel() const { return _store->GetModel(_slot); }
+unsigned int CarView::GetRegisterYear() const { return _store->GetRegisterYear(_slot); }
+double CarView::GetInitialPrice() const { return _store->GetInitialPrice(_slot); }
+double CarView::GetSalePrice() const { return _store->GetSalePrice(_slot); }
+std::chrono::system_clock::time_point CarView::GetAddTime() const { return _store->GetAddTime(_slot); }
+bool CarView::IsSold() const { return _store->IsSold(_slot); }
+
+double CarView::CalculateCurrentPrice(std::chrono::system_clock::time_point currentTime) const
+{
+    return Car::CalculatePrice(GetInitialPrice(), GetAddTime(), currentTime);
+}
+
+void CarView::ShowCarInfo(std::chrono::system_clock::time_point currentTime) const
+{
+    ShowCarInfoWithPrice(CalculateCurrentPrice(currentTime));
+}
+
+void CarView::ShowCarInfoWithPrice(double currentPrice) const
+{
+    std::cout << "ID: " << GetId() << "\n";
+    std::cout << "Model: " << GetModel() << "\n";
+    std::cout << "Register Year: " << GetRegisterYear() << "\n";
+    std::cout << "Actual Price: " << currentPrice << "\n";
+    std::cout << "Status: " << (IsSold() ? "Sold" : "Available") << "\n";
+}
+
+void CarView::ShowCarInfo() const
+{
+    std::cout << "ID: " << GetId() << "\n";
+    std::cout << "Model: " << GetModel() << "\n";
+    std::cout << "Register Year: " << GetRegisterYear() << "\n";
+    std::cout << "Sell Price: " << GetInitialPrice() << "\n";
+    std::cout << "Status: " << (IsSold() ? "Sold" : "Available") << "\n";
+}
@@ -0,0 +1,22 @@
+#include "Clock.hpp"
+
+CoarseClock::CoarseClock(std::chrono::system_clock::duration interval)
+    : _now(std::chrono::system_clock::now().time_since_epoch().count()), _stop(false), _interval(interval)
+{
+    _ticker = std::thread(&CoarseClock::Tick, this);
+}
+
+CoarseClock::~CoarseClock()
+{
+    _stop.store(true, std::memory_order_relaxed);
+    _ticker.join();
+}
+
+void CoarseClock::Tick()
+{
+    while (!_stop.load(std::memory_order_relaxed))
+    {
+        std::this_thread::sleep_for(_interval);
+        _now.store(std::chrono::system_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    }
+}
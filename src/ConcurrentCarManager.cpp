@@ -0,0 +1,252 @@
+#include "ConcurrentCarManager.hpp"
+#include <mutex>
+#include <thread>
+
+ConcurrentCarManager::Shard::~Shard()
+{
+    for (std::size_t chunk = 0; chunk < kMaxChunks; chunk++)
+    {
+        delete[] chunks[chunk].load(std::memory_order_relaxed);
+    }
+}
+
+ConcurrentCarManager::ConcurrentCarManager(std::size_t shardCount, const DepreciationSchedule &depreciation,
+                                           const Clock &clock)
+    : _shardBits(0), _depreciation(depreciation), _clock(&clock), _nextCarId(1), _carCount(0), _soldCount(0), _nextVersion(1)
+{
+    if (shardCount == 0)
+    {
+        // A few shards per core keeps two terminals from hitting the same lock often.
+        shardCount = std::thread::hardware_concurrency() * 4;
+        shardCount = shardCount > 0 ? shardCount : 16;
+    }
+
+    std::size_t rounded = 1;
+    while (rounded < shardCount)
+    {
+        rounded *= 2;
+        _shardBits++;
+    }
+
+    _shards.reset(new Shard[rounded]);
+    _shardMask = rounded - 1;
+}
+
+ConcurrentCarManager::Entry *ConcurrentCarManager::FindCar(unsigned int id) const
+{
+    std::size_t slot = SlotOf(id);
+    if (slot >= kChunkSize * kMaxChunks)
+    {
+        return nullptr;
+    }
+
+    // The acquire load of addedVersion makes the car's fields visible.
+    Entry *car = ShardOf(id).Find(slot);
+    return car != nullptr && car->addedVersion.load(std::memory_order_acquire) != 0 ? car : nullptr;
+}
+
+void ConcurrentCarManager::WaitForAdds(std::uint64_t version) const
+{
+    // An add announces itself before it takes its version, so any add with a
+    // version up to ours is either finished or still announced here.
+    for (std::size_t s = 0; s <= _shardMask; s++)
+    {
+        const Shard &shard = _shards[s];
+        for (;;)
+        {
+            std::uint64_t adding = shard.addingVersion.load();
+            if (adding == kNoAdd || (adding != kVersionPending && adding > version))
+            {
+                break;
+            }
+            std::this_thread::yield();
+        }
+    }
+}
+
+std::uint64_t ConcurrentCarManager::SoldVersion(const Entry &car)
+{
+    // A sale claims the car before it takes its version, so a sale with a
+    // version up to the view's is never missed here; it may just not have
+    // stored its version yet.
+    if (car.state.load() == Available)
+    {
+        return kNotSold;
+    }
+
+    std::uint64_t version;
+    while ((version = car.soldVersion.load(std::memory_order_acquire)) == kNotSold)
+    {
+        std::this_thread::yield();
+    }
+    return version;
+}
+
+unsigned int ConcurrentCarManager::AddCar(std::string_view model, unsigned int registerYear, double initialPrice)
+{
+    auto addTime = _clock->Now();
+    unsigned int id = _nextCarId.fetch_add(1);
+    std::size_t slot = SlotOf(id);
+    Shard &shard = ShardOf(id);
+
+    if (slot >= kChunkSize * kMaxChunks)
+    {
+        return 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto &chunk = shard.chunks[slot >> kChunkBits];
+        if (chunk.load(std::memory_order_relaxed) == nullptr)
+        {
+            chunk.store(new Entry[kChunkSize], std::memory_order_release);
+        }
+
+        Entry &car = *shard.Find(slot);
+        car.id = id;
+        car.model.assign(model.data(), model.size());
+        car.registerYear = registerYear;
+        car.initialPrice = initialPrice;
+        car.addTime = addTime;
+
+        // Announce the add before taking the version, so a view that gets
+        // this version or a later one waits for the car to be stored.
+        shard.addingVersion.store(kVersionPending);
+        std::uint64_t version = _nextVersion.fetch_add(1);
+        shard.addingVersion.store(version);
+
+        car.addedVersion.store(version, std::memory_order_release);
+        shard.addingVersion.store(kNoAdd, std::memory_order_release);
+    }
+
+    _carCount.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+bool ConcurrentCarManager::SellCar(unsigned int id, double *salePrice)
+{
+    auto currentTime = _clock->Now();
+    Entry *car = FindCar(id);
+    if (car == nullptr)
+    {
+        return false;
+    }
+
+    // Only one seller can move the car out of Available.
+    unsigned char expected = Available;
+    if (!car->state.compare_exchange_strong(expected, Claimed))
+    {
+        return false;
+    }
+
+    double price = _depreciation.Price(car->initialPrice, car->addTime, currentTime);
+    car->salePrice = price;
+
+    std::uint64_t version = _nextVersion.fetch_add(1);
+    car->soldVersion.store(version, std::memory_order_release);
+    car->state.store(Sold, std::memory_order_release);
+
+    _soldCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (salePrice != nullptr)
+    {
+        *salePrice = price;
+    }
+    return true;
+}
+
+bool ConcurrentCarManager::IsCarSold(unsigned int id) const
+{
+    const Entry *car = FindCar(id);
+    return car != nullptr && car->state.load(std::memory_order_relaxed) != Available;
+}
+
+bool ConcurrentCarManager::GetSalePrice(unsigned int id, double &salePrice) const
+{
+    const Entry *car = FindCar(id);
+    if (car == nullptr || car->state.load(std::memory_order_acquire) != Sold)
+    {
+        return false;
+    }
+
+    salePrice = car->salePrice;
+    return true;
+}
+
+InventoryView ConcurrentCarManager::GetView() const
+{
+    // The version first: every car added up to it already had its ID.
+    std::uint64_t version = _nextVersion.load() - 1;
+    return InventoryView(*this, version, _nextCarId.load() - 1);
+}
+
+std::vector<CarSnapshot> InventoryView::GetCars() const
+{
+    std::vector<CarSnapshot> cars;
+    ForEachCar([&](const CarSnapshot &car)
+               { cars.push_back(car); });
+    return cars;
+}
+
+void InventoryView::ShowAvailableCars(std::ostream &out, std::chrono::system_clock::time_point currentTime) const
+{
+    ReportBuffer report;
+    report.UseFloatFormatOf(out);
+    report.Append("--- Available Cars ---\n");
+
+    bool foundAvailable = false;
+    ForEachCar([&](const CarSnapshot &car)
+               {
+                   if (!car.isSold)
+                   {
+                       double price = _manager->_depreciation.Price(car.initialPrice, car.addTime, currentTime);
+                       report.Append("ID: ").Append(car.id);
+                       report.Append("\nModel: ").Append(car.model);
+                       report.Append("\nRegister Year: ").Append(car.registerYear);
+                       report.Append("\nActual Price: ").Append(price);
+                       report.Append("\nStatus: Available\n");
+                       report.Append("----------------------\n");
+                       foundAvailable = true;
+                   } });
+
+    if (!foundAvailable)
+    {
+        report.Append("No cars currently available for sale.\n");
+    }
+    report.WriteTo(out);
+}
+
+void InventoryView::ShowDailyReport(std::ostream &out) const
+{
+    ReportBuffer report;
+    ReportBuffer available;
+    report.UseFloatFormatOf(out);
+    available.UseFloatFormatOf(out);
+
+    report.Append("----------- Day Report ---------\n");
+    report.Append("----------- Sold Cars ---------\n");
+
+    std::size_t soldCount = 0;
+    std::size_t availableCount = 0;
+
+    ForEachCar([&](const CarSnapshot &car)
+               {
+                   ReportBuffer &part = car.isSold ? report : available;
+                   (car.isSold ? soldCount : availableCount)++;
+
+                   part.Append("ID: ").Append(car.id);
+                   part.Append("\nModel: ").Append(car.model);
+                   part.Append("\nRegister Year: ").Append(car.registerYear);
+                   part.Append("\nSell Price: ").Append(car.initialPrice);
+                   part.Append(car.isSold ? "\nStatus: Sold\n" : "\nStatus: Available\n");
+                   part.Append("----------------------\n"); });
+
+    report.Append("----------- Not Sold Cars ---------\n");
+    report.Append(available);
+    report.Append("Summary: Sold - ").Append(soldCount);
+    report.Append(", Available - ").Append(availableCount).Append("\n");
+    report.Append("----------------------------------\n");
+
+    report.WriteTo(out);
+}
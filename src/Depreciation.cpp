@@ -0,0 +1,48 @@
+#include "Depreciation.hpp"
+
+CAR_PRICE_KERNEL_CLONES
+void DepreciatedPrices(const DepreciationSchedule &schedule, const std::chrono::system_clock::rep *addTimes,
+                       const double *initialPrices, std::size_t count,
+                       std::chrono::system_clock::time_point currentTime, double *prices)
+{
+    // One check per batch; each branch runs the loop with its schedule fully inlined.
+    if (const auto *linear = std::get_if<LinearDepreciation>(&schedule))
+    {
+        DepreciatedPrices(*linear, addTimes, initialPrices, count, currentTime, prices);
+    }
+    else if (const auto *exponential = std::get_if<ExponentialDepreciation>(&schedule))
+    {
+        DepreciatedPrices(*exponential, addTimes, initialPrices, count, currentTime, prices);
+    }
+    else if (const auto *tabulated = std::get_if<TabulatedDepreciation>(&schedule))
+    {
+        DepreciatedPrices(*tabulated, addTimes, initialPrices, count, currentTime, prices);
+    }
+}
+
+DepreciationPricer::DepreciationPricer(const DepreciationSchedule &schedule) : _schedule(schedule), _useTable(false)
+{
+    std::visit([&](const auto &policy)
+               {
+                   if (FitsMultiplierTable<kTableSteps>(policy))
+                   {
+                       _table = MakeMultiplierTable<kTableSteps>(policy);
+                       _useTable = true;
+                   } },
+               _schedule);
+}
+
+CAR_PRICE_KERNEL_CLONES
+void DepreciationPricer::Prices(const std::chrono::system_clock::rep *addTimes, const double *initialPrices,
+                                std::size_t count, std::chrono::system_clock::time_point currentTime,
+                                double *prices) const
+{
+    if (_useTable)
+    {
+        DepreciatedPrices(_table, addTimes, initialPrices, count, currentTime, prices);
+    }
+    else
+    {
+        DepreciatedPrices(_schedule, addTimes, initialPrices, count, currentTime, prices);
+    }
+}
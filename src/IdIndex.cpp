@@ -0,0 +1,97 @@
+#include "IdIndex.hpp"
+
+namespace
+{
+    constexpr std::size_t kMinCapacity = 16;
+}
+
+std::size_t IdIndex::Bucket(unsigned int id) const
+{
+    // Fibonacci hashing spreads both sequential and clustered IDs nicely.
+    unsigned long long hash = static_cast<unsigned long long>(id) * 0x9E3779B97F4A7C15ull;
+    return static_cast<std::size_t>(hash >> 32) & _mask;
+}
+
+std::size_t IdIndex::Find(unsigned int id) const
+{
+    if (_slots.empty())
+    {
+        return npos;
+    }
+
+    for (std::size_t i = Bucket(id);; i = (i + 1) & _mask)
+    {
+        if (_slots[i] == npos)
+        {
+            return npos;
+        }
+        if (_keys[i] == id)
+        {
+            return _slots[i];
+        }
+    }
+}
+
+bool IdIndex::Insert(unsigned int id, std::size_t slot)
+{
+    // Keep the load factor at or below 1/2 so probe chains stay short.
+    if ((_size + 1) * 2 > _slots.size())
+    {
+        Rehash(_slots.empty() ? kMinCapacity : _slots.size() * 2);
+    }
+
+    for (std::size_t i = Bucket(id);; i = (i + 1) & _mask)
+    {
+        if (_slots[i] == npos)
+        {
+            _keys[i] = id;
+            _slots[i] = slot;
+            _size++;
+            return true;
+        }
+        if (_keys[i] == id)
+        {
+            return false;
+        }
+    }
+}
+
+void IdIndex::Reserve(std::size_t count)
+{
+    std::size_t capacity = kMinCapacity;
+    while (capacity < count * 2)
+    {
+        capacity *= 2;
+    }
+
+    if (capacity > _slots.size())
+    {
+        Rehash(capacity);
+    }
+}
+
+void IdIndex::Clear()
+{
+    _keys.clear();
+    _slots.clear();
+    _size = 0;
+    _mask = 0;
+}
+
+void IdIndex::Rehash(std::size_t newCapacity)
+{
+    std::vector<unsigned int> oldKeys(newCapacity);
+    std::vector<std::size_t> oldSlots(newCapacity, npos);
+    oldKeys.swap(_keys);
+    oldSlots.swap(_slots);
+    _mask = newCapacity - 1;
+    _size = 0;
+
+    for (std::size_t i = 0; i < oldSlots.size(); i++)
+    {
+        if (oldSlots[i] != npos)
+        {
+            Insert(oldKeys[i], oldSlots[i]);
+        }
+    }
+}
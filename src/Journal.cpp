@@ -0,0 +1,346 @@
+#include "Journal.hpp"
+#include "MappedFile.hpp"
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#define CAR_FILENO _fileno
+#define CAR_FSYNC _commit
+#define CAR_FTRUNCATE _chsize_s
+#else
+#include <unistd.h>
+#define CAR_FILENO fileno
+#define CAR_FSYNC fsync
+#define CAR_FTRUNCATE ftruncate
+#endif
+
+namespace
+{
+    constexpr char kMagic[8] = {'C', 'A', 'R', 'J', 'R', 'N', 'L', '\0'};
+    constexpr std::uint32_t kVersion = 1;
+
+    struct FileHeader
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t reserved;
+    };
+
+    struct RecordHeader
+    {
+        std::uint32_t type;
+        std::uint32_t size;     ///< Payload bytes after this header.
+        std::uint64_t checksum; ///< Checksum of type and payload.
+    };
+
+    struct AddPayload
+    {
+        std::uint32_t id;
+        std::uint32_t registerYear;
+        double initialPrice;
+        std::int64_t addTime;
+        // followed by the model name bytes
+    };
+
+    struct SellPayload
+    {
+        std::uint32_t id;
+        std::uint32_t reserved;
+        double salePrice;
+    };
+
+    // FNV-1a, continued over the given bytes.
+    std::uint64_t UpdateChecksum(std::uint64_t hash, const char *data, std::size_t size)
+    {
+        for (std::size_t i = 0; i < size; i++)
+        {
+            hash = (hash ^ static_cast<unsigned char>(data[i])) * 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    std::uint64_t RecordChecksum(std::uint32_t type, const char *payload, std::size_t size)
+    {
+        return UpdateChecksum(0xcbf29ce484222325ull ^ type, payload, size);
+    }
+
+    // Decodes one record; returns false if the bytes do not form a valid record.
+    bool DecodeRecord(std::uint32_t type, const char *payload, std::size_t size, JournalRecord &record)
+    {
+        if (type == static_cast<std::uint32_t>(JournalRecord::Type::Add) && size >= sizeof(AddPayload))
+        {
+            AddPayload add;
+            std::memcpy(&add, payload, sizeof(add));
+            record.type = JournalRecord::Type::Add;
+            record.id = add.id;
+            record.registerYear = add.registerYear;
+            record.initialPrice = add.initialPrice;
+            record.addTime = add.addTime;
+            record.salePrice = 0.0;
+            record.model = std::string_view(payload + sizeof(add), size - sizeof(add));
+            return true;
+        }
+
+        if (type == static_cast<std::uint32_t>(JournalRecord::Type::Sell) && size == sizeof(SellPayload))
+        {
+            SellPayload sell;
+            std::memcpy(&sell, payload, sizeof(sell));
+            record = JournalRecord();
+            record.type = JournalRecord::Type::Sell;
+            record.id = sell.id;
+            record.salePrice = sell.salePrice;
+            return true;
+        }
+
+        return false;
+    }
+}
+
+Journal::~Journal()
+{
+    Close();
+}
+
+bool Journal::Open(const std::string &filename, const std::function<void(const JournalRecord &)> &replay)
+{
+    Close();
+    _recordCount = 0;
+
+    std::size_t goodEnd = 0;
+    {
+        MappedFile existing;
+        if (existing.Open(filename) && existing.Size() > 0)
+        {
+            std::string_view data = existing.Data();
+            FileHeader header;
+
+            if (data.size() < sizeof(header) || std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0)
+            {
+                Report(EventLevel::Error, "Not a journal file: " + filename);
+                return false;
+            }
+
+            std::memcpy(&header, data.data(), sizeof(header));
+            if (header.version != kVersion)
+            {
+                Report(EventLevel::Error, "Unsupported journal version: " + filename);
+                return false;
+            }
+
+            // Replay records until the end, or until the first damaged one.
+            std::size_t position = sizeof(header);
+            while (position + sizeof(RecordHeader) <= data.size())
+            {
+                RecordHeader recordHeader;
+                std::memcpy(&recordHeader, data.data() + position, sizeof(recordHeader));
+                const char *payload = data.data() + position + sizeof(recordHeader);
+
+                if (recordHeader.size > data.size() - position - sizeof(recordHeader) ||
+                    recordHeader.checksum != RecordChecksum(recordHeader.type, payload, recordHeader.size))
+                {
+                    break;
+                }
+
+                JournalRecord record;
+                if (!DecodeRecord(recordHeader.type, payload, recordHeader.size, record))
+                {
+                    break;
+                }
+
+                replay(record);
+                _recordCount++;
+                position += sizeof(recordHeader) + recordHeader.size;
+            }
+
+            goodEnd = position;
+            if (goodEnd != data.size())
+            {
+                Report(EventLevel::Warning, "Dropping damaged journal tail (" + std::to_string(data.size() - goodEnd) + " bytes) in " + filename);
+            }
+        }
+    }
+
+    _file = std::fopen(filename.c_str(), goodEnd > 0 ? "r+b" : "w+b");
+    if (_file == nullptr)
+    {
+        Report(EventLevel::Error, "Could not open journal: " + filename);
+        return false;
+    }
+
+    if (goodEnd == 0)
+    {
+        FileHeader header = {};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        std::fwrite(&header, sizeof(header), 1, _file);
+        std::fflush(_file);
+    }
+    else
+    {
+        // Cut the damaged tail off, or new records would land behind it and never be replayed.
+        if (CAR_FTRUNCATE(CAR_FILENO(_file), static_cast<long>(goodEnd)) != 0)
+        {
+            Report(EventLevel::Error, "Could not cut the damaged tail off journal: " + filename);
+            std::fclose(_file);
+            _file = nullptr;
+            return false;
+        }
+        std::fseek(_file, 0, SEEK_END);
+    }
+
+    _unsyncedCount = 0;
+    return true;
+}
+
+void Journal::Report(EventLevel level, const std::string &text) const
+{
+    if (_onMessage)
+    {
+        _onMessage(level, text);
+    }
+}
+
+void Journal::Close()
+{
+    if (_file != nullptr)
+    {
+        Sync();
+        std::fclose(_file);
+        _file = nullptr;
+    }
+}
+
+void Journal::Encode(JournalRecord::Type type, const void *payload, std::size_t size, std::string_view extra,
+                     std::vector<char> &buffer)
+{
+    const char *bytes = static_cast<const char *>(payload);
+
+    // The checksum covers payload and extra as if they were one block.
+    RecordHeader header;
+    header.type = static_cast<std::uint32_t>(type);
+    header.size = static_cast<std::uint32_t>(size + extra.size());
+    header.checksum = UpdateChecksum(RecordChecksum(header.type, bytes, size), extra.data(), extra.size());
+
+    // Appended part by part; empty parts are skipped (extra.data() may be null).
+    const char *headerBytes = reinterpret_cast<const char *>(&header);
+    buffer.insert(buffer.end(), headerBytes, headerBytes + sizeof(header));
+    if (size > 0)
+    {
+        buffer.insert(buffer.end(), bytes, bytes + size);
+    }
+    if (extra.size() > 0)
+    {
+        buffer.insert(buffer.end(), extra.begin(), extra.end());
+    }
+}
+
+bool Journal::Write(const std::vector<char> &buffer, std::size_t recordCount)
+{
+    if (_file == nullptr)
+    {
+        return false;
+    }
+
+    if (std::fwrite(buffer.data(), buffer.size(), 1, _file) != 1 || std::fflush(_file) != 0)
+    {
+        Report(EventLevel::Error, "Could not write to journal.");
+        return false;
+    }
+
+    _recordCount += recordCount;
+    _unsyncedCount += recordCount;
+    if (_unsyncedCount >= _syncEvery)
+    {
+        return Sync();
+    }
+    return true;
+}
+
+bool Journal::AppendAdd(unsigned int id, std::string_view model, unsigned int registerYear,
+                        double initialPrice, std::int64_t addTime)
+{
+    // Build the whole record first so it goes out in one write.
+    std::vector<char> buffer;
+    AddPayload add = {id, registerYear, initialPrice, addTime};
+    Encode(JournalRecord::Type::Add, &add, sizeof(add), model, buffer);
+    return Write(buffer, 1);
+}
+
+bool Journal::AppendSell(unsigned int id, double salePrice)
+{
+    std::vector<char> buffer;
+    SellPayload sell = {id, 0, salePrice};
+    Encode(JournalRecord::Type::Sell, &sell, sizeof(sell), std::string_view(), buffer);
+    return Write(buffer, 1);
+}
+
+bool Journal::AppendRecords(const std::vector<JournalRecord> &records)
+{
+    if (records.empty())
+    {
+        return true;
+    }
+
+    // All records go out in one write, however many there are.
+    std::vector<char> buffer;
+    for (const auto &record : records)
+    {
+        if (record.type == JournalRecord::Type::Add)
+        {
+            AddPayload add = {record.id, record.registerYear, record.initialPrice, record.addTime};
+            Encode(JournalRecord::Type::Add, &add, sizeof(add), record.model, buffer);
+        }
+        else
+        {
+            SellPayload sell = {record.id, 0, record.salePrice};
+            Encode(JournalRecord::Type::Sell, &sell, sizeof(sell), std::string_view(), buffer);
+        }
+    }
+    return Write(buffer, records.size());
+}
+
+bool Journal::Sync()
+{
+    if (_file == nullptr)
+    {
+        return false;
+    }
+    if (_unsyncedCount == 0)
+    {
+        return true;
+    }
+
+    // On failure the records stay counted as unsynced, so the next Sync tries again.
+    if (std::fflush(_file) != 0 || CAR_FSYNC(CAR_FILENO(_file)) != 0)
+    {
+        Report(EventLevel::Error, "Could not sync journal to disk.");
+        return false;
+    }
+    _unsyncedCount = 0;
+    return true;
+}
+
+bool Journal::Truncate()
+{
+    if (_file == nullptr)
+    {
+        return false;
+    }
+
+    std::fflush(_file);
+    if (CAR_FTRUNCATE(CAR_FILENO(_file), static_cast<long>(sizeof(FileHeader))) != 0)
+    {
+        Report(EventLevel::Error, "Could not truncate journal.");
+        return false;
+    }
+    std::fseek(_file, 0, SEEK_END);
+    _recordCount = 0;
+    _unsyncedCount = 0;
+    if (CAR_FSYNC(CAR_FILENO(_file)) != 0)
+    {
+        Report(EventLevel::Error, "Could not sync journal to disk.");
+        return false;
+    }
+    return true;
+}
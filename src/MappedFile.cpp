@@ -0,0 +1,93 @@
+#include "MappedFile.hpp"
+
+#if defined(__APPLE__) || defined(__linux__) || defined(__unix__)
+#define CAR_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+#ifdef CAR_HAVE_MMAP
+
+bool MappedFile::Open(const std::string &filename)
+{
+    Close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    std::size_t size = static_cast<std::size_t>(info.st_size);
+    if (size > 0)
+    {
+        void *mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            ::close(fd);
+            return false;
+        }
+        // We read the file front to back, let the kernel know.
+        ::madvise(mapping, size, MADV_SEQUENTIAL);
+        _data = static_cast<const char *>(mapping);
+        _size = size;
+    }
+
+    // The mapping stays valid after the descriptor is closed.
+    ::close(fd);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (_data != nullptr && _size > 0)
+    {
+        ::munmap(const_cast<char *>(_data), _size);
+    }
+    _data = nullptr;
+    _size = 0;
+}
+
+#else
+
+bool MappedFile::Open(const std::string &filename)
+{
+    Close();
+
+    std::ifstream inFile(filename, std::ios::binary);
+    if (!inFile.is_open())
+    {
+        return false;
+    }
+
+    _fallback.assign(std::istreambuf_iterator<char>(inFile), std::istreambuf_iterator<char>());
+    _data = _fallback.data();
+    _size = _fallback.size();
+    return true;
+}
+
+void MappedFile::Close()
+{
+    _fallback.clear();
+    _data = nullptr;
+    _size = 0;
+}
+
+#endif
@@ -0,0 +1,47 @@
+#include "ModelDictionary.hpp"
+
+std::uint32_t ModelDictionary::Intern(std::string_view name)
+{
+    auto it = _ids.find(name);
+    if (it != _ids.end())
+    {
+        return it->second;
+    }
+
+    std::uint32_t id = static_cast<std::uint32_t>(_names.size());
+    std::string_view stored = _arena.Store(name);
+    _names.push_back(stored);
+    _ids.emplace(stored, id);
+    return id;
+}
+
+std::uint32_t ModelDictionary::Find(std::string_view name) const
+{
+    auto it = _ids.find(name);
+    return it != _ids.end() ? it->second : npos;
+}
+
+void ModelDictionary::Assign(const std::uint64_t *starts, const char *pool, std::size_t count)
+{
+    Clear();
+
+    // All names go into the arena in one copy, then each ID points into it.
+    std::size_t poolSize = count > 0 ? starts[count] : 0;
+    _arena.Reserve(poolSize);
+    const char *copy = _arena.Store(std::string_view(pool, poolSize)).data();
+
+    _names.resize(count);
+    _ids.reserve(count);
+    for (std::size_t id = 0; id < count; id++)
+    {
+        _names[id] = std::string_view(copy + starts[id], starts[id + 1] - starts[id]);
+        _ids.emplace(_names[id], static_cast<std::uint32_t>(id));
+    }
+}
+
+void ModelDictionary::Clear()
+{
+    _ids.clear();
+    _names.clear();
+    _arena.Clear();
+}
@@ -0,0 +1,87 @@
+#include "ModelIndex.hpp"
+#include <algorithm>
+
+void ModelIndex::Add(std::size_t slot, std::uint32_t modelId, std::string_view model, bool sold)
+{
+    if (_available.size() <= modelId)
+    {
+        _available.resize(modelId + 1);
+        _named.resize(modelId + 1, false);
+    }
+    if (!_named[modelId])
+    {
+        _modelIds.emplace(model, modelId);
+        _named[modelId] = true;
+    }
+
+    if (_slotModels.size() <= slot)
+    {
+        _slotModels.resize(slot + 1, 0);
+        _slotPositions.resize(slot + 1, npos);
+    }
+
+    _slotModels[slot] = modelId;
+
+    if (sold)
+    {
+        _slotPositions[slot] = npos;
+    }
+    else
+    {
+        _slotPositions[slot] = _available[modelId].size();
+        _available[modelId].push_back(slot);
+    }
+}
+
+void ModelIndex::MarkSold(std::size_t slot)
+{
+    std::size_t position = _slotPositions[slot];
+    if (position == npos)
+    {
+        return;
+    }
+
+    // Move the last car of the list into the hole.
+    auto &postings = _available[_slotModels[slot]];
+    std::size_t last = postings.back();
+    postings[position] = last;
+    _slotPositions[last] = position;
+    postings.pop_back();
+
+    _slotPositions[slot] = npos;
+}
+
+void ModelIndex::Reserve(std::size_t carCount)
+{
+    _slotModels.reserve(carCount);
+    _slotPositions.reserve(carCount);
+}
+
+void ModelIndex::Clear()
+{
+    _modelIds.clear();
+    _available.clear();
+    _named.clear();
+    _slotModels.clear();
+    _slotPositions.clear();
+}
+
+std::vector<std::size_t> ModelIndex::FindAvailable(std::string_view prefix) const
+{
+    std::vector<std::size_t> slots;
+
+    // All names starting with the prefix sit next to each other in the sorted map.
+    for (auto it = _modelIds.lower_bound(prefix); it != _modelIds.end(); ++it)
+    {
+        if (it->first.compare(0, prefix.size(), prefix) != 0)
+        {
+            break;
+        }
+
+        const auto &postings = _available[it->second];
+        slots.insert(slots.end(), postings.begin(), postings.end());
+    }
+
+    std::sort(slots.begin(), slots.end());
+    return slots;
+}
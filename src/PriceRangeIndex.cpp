@@ -0,0 +1,262 @@
+#include "PriceRangeIndex.hpp"
+#include "CarStore.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+
+namespace
+{
+    std::int64_t AddSecond(std::chrono::system_clock::time_point addTime)
+    {
+        return std::chrono::floor<std::chrono::seconds>(addTime.time_since_epoch()).count();
+    }
+
+    // Whole seconds a car added during second addSecond has been in stock at currentTime, at least and at most.
+    void ElapsedSeconds(std::int64_t addSecond, std::chrono::system_clock::time_point currentTime, long long &low, long long &high)
+    {
+        auto sinceGroup = currentTime.time_since_epoch() - std::chrono::seconds(addSecond);
+        auto latest = sinceGroup - std::chrono::seconds(1) + std::chrono::system_clock::duration(1);
+        low = std::chrono::duration_cast<std::chrono::seconds>(latest).count();
+        high = std::chrono::duration_cast<std::chrono::seconds>(sinceGroup).count();
+    }
+}
+
+void PriceRangeIndex::Add(std::size_t slot, double initialPrice, std::chrono::system_clock::time_point addTime)
+{
+    if (!_valid)
+    {
+        return;
+    }
+
+    Group &group = _stepping[AddSecond(addTime)];
+    if (!group.entries.empty() && initialPrice < group.entries.back().initialPrice)
+    {
+        group.sorted = false;
+    }
+    group.entries.push_back({initialPrice, slot});
+}
+
+void PriceRangeIndex::MarkSold(const CarStore &store, std::size_t slot)
+{
+    if (!_valid)
+    {
+        return;
+    }
+
+    auto found = _stepping.find(AddSecond(store.GetAddTime(slot)));
+    if (found == _stepping.end())
+    {
+        // Not stepping any more, so the car is in one of the capped runs.
+        std::size_t cappedSize = 0;
+        for (const auto &run : _capped)
+        {
+            cappedSize += run.size();
+        }
+        if (++_cappedSold * 2 > cappedSize)
+        {
+            DropSoldCapped(store);
+        }
+        return;
+    }
+
+    Group &group = found->second;
+    if (++group.sold * 2 > group.entries.size())
+    {
+        group.entries.erase(std::remove_if(group.entries.begin(), group.entries.end(), [&](const Entry &entry)
+                                           { return store.IsSold(entry.slot); }),
+                            group.entries.end());
+        group.sold = 0;
+        if (group.entries.empty())
+        {
+            _stepping.erase(found);
+        }
+    }
+}
+
+void PriceRangeIndex::Invalidate()
+{
+    _valid = false;
+    _stepping.clear();
+    _capped.clear();
+    _cappedSold = 0;
+}
+
+void PriceRangeIndex::Rebuild(const CarStore &store, const DepreciationPricer &pricer, std::chrono::system_clock::time_point currentTime)
+{
+    Invalidate();
+    _valid = true;
+    _now = currentTime;
+
+    // Cars mostly come in add time order, so consecutive cars usually share a group.
+    std::int64_t lastSecond = 0;
+    Group *lastGroup = nullptr;
+    store.ForEachAvailable([&](std::size_t slot)
+                           {
+                               std::int64_t second = AddSecond(store.GetAddTime(slot));
+                               if (lastGroup == nullptr || second != lastSecond)
+                               {
+                                   lastGroup = &_stepping[second];
+                                   lastSecond = second;
+                               }
+                               double initialPrice = store.GetInitialPrice(slot);
+                               if (!lastGroup->entries.empty() && initialPrice < lastGroup->entries.back().initialPrice)
+                               {
+                                   lastGroup->sorted = false;
+                               }
+                               lastGroup->entries.push_back({initialPrice, slot}); });
+
+    MoveCappedGroups(store, pricer);
+}
+
+void PriceRangeIndex::MoveCappedGroups(const CarStore &store, const DepreciationPricer &pricer)
+{
+    // The oldest groups cap first; stop at the first one that is still stepping.
+    std::vector<Entry> run;
+    auto group = _stepping.begin();
+    for (; group != _stepping.end(); ++group)
+    {
+        long long low, high;
+        ElapsedSeconds(group->first, _now, low, high);
+        if (!pricer.IsCappedAfter(low))
+        {
+            break;
+        }
+        std::copy_if(group->second.entries.begin(), group->second.entries.end(), std::back_inserter(run),
+                     [&](const Entry &entry)
+                     { return !store.IsSold(entry.slot); });
+    }
+
+    _stepping.erase(_stepping.begin(), group);
+    if (run.empty())
+    {
+        return;
+    }
+
+    std::sort(run.begin(), run.end());
+    AddCappedRun(store, std::move(run));
+}
+
+void PriceRangeIndex::AddCappedRun(const CarStore &store, std::vector<Entry> run)
+{
+    _capped.push_back(std::move(run));
+
+    // Like carrying in a binary counter: merge while the newest run is no longer much smaller.
+    while (_capped.size() >= 2 && _capped[_capped.size() - 2].size() < 2 * _capped.back().size())
+    {
+        std::vector<Entry> &older = _capped[_capped.size() - 2];
+        std::vector<Entry> &newer = _capped.back();
+        std::vector<Entry> merged;
+        merged.reserve(older.size() + newer.size());
+        std::merge(older.begin(), older.end(), newer.begin(), newer.end(), std::back_inserter(merged));
+
+        // Sold cars stop taking up room here.
+        auto kept = std::remove_if(merged.begin(), merged.end(), [&](const Entry &entry)
+                                   { return store.IsSold(entry.slot); });
+        _cappedSold -= std::min<std::size_t>(_cappedSold, merged.end() - kept);
+        merged.erase(kept, merged.end());
+
+        _capped.pop_back();
+        _capped.back() = std::move(merged);
+    }
+}
+
+void PriceRangeIndex::DropSoldCapped(const CarStore &store)
+{
+    // Filter every run, then add them back oldest (biggest) first, so runs
+    // that shrank a lot are merged again like any new run.
+    std::vector<std::vector<Entry>> runs = std::move(_capped);
+    _capped.clear();
+    for (auto &run : runs)
+    {
+        run.erase(std::remove_if(run.begin(), run.end(), [&](const Entry &entry)
+                                 { return store.IsSold(entry.slot); }),
+                  run.end());
+        if (!run.empty())
+        {
+            AddCappedRun(store, std::move(run));
+        }
+    }
+    _cappedSold = 0;
+}
+
+std::size_t PriceRangeIndex::GetEntryCount() const
+{
+    std::size_t count = 0;
+    for (const auto &[addSecond, group] : _stepping)
+    {
+        count += group.entries.size();
+    }
+    for (const auto &run : _capped)
+    {
+        count += run.size();
+    }
+    return count;
+}
+
+std::vector<std::size_t> PriceRangeIndex::Find(const CarStore &store, const DepreciationPricer &pricer, double minPrice, double maxPrice,
+                                               std::chrono::system_clock::time_point currentTime)
+{
+    if (!_valid || currentTime < _now)
+    {
+        Rebuild(store, pricer, currentTime);
+    }
+    _now = currentTime;
+    MoveCappedGroups(store, pricer);
+
+    std::vector<std::size_t> slots;
+    if (!(minPrice <= maxPrice))
+    {
+        return slots;
+    }
+
+    // Looks up the initial prices that can give a price in range for multipliers
+    // between lowest and highest, then checks the exact price of each candidate.
+    auto collect = [&](const std::vector<Entry> &entries, double lowest, double highest)
+    {
+        double lowInitial = highest > 0.0 ? minPrice / highest : -std::numeric_limits<double>::infinity();
+        double highInitial = lowest > 0.0 ? maxPrice / lowest : std::numeric_limits<double>::infinity();
+        // A little slack for the rounding of the division; the exact check below decides.
+        lowInitial -= std::abs(lowInitial) * 1e-9;
+        highInitial += std::abs(highInitial) * 1e-9;
+
+        auto entry = std::lower_bound(entries.begin(), entries.end(), Entry{lowInitial, 0});
+        for (; entry != entries.end() && entry->initialPrice <= highInitial; ++entry)
+        {
+            if (store.IsSold(entry->slot))
+            {
+                continue;
+            }
+            double price = pricer.Price(entry->initialPrice, store.GetAddTime(entry->slot), currentTime);
+            if (price >= minPrice && price <= maxPrice)
+            {
+                slots.push_back(entry->slot);
+            }
+        }
+    };
+
+    // Capped cars all share the multiplier of the last step.
+    const double cappedMultiplier = pricer.MultiplierAfter(std::numeric_limits<long long>::max() / 2);
+    for (const auto &run : _capped)
+    {
+        collect(run, cappedMultiplier, cappedMultiplier);
+    }
+
+    for (auto &[addSecond, group] : _stepping)
+    {
+        if (!group.sorted)
+        {
+            std::sort(group.entries.begin(), group.entries.end());
+            group.sorted = true;
+        }
+
+        long long low, high;
+        ElapsedSeconds(addSecond, currentTime, low, high);
+        double first = pricer.MultiplierAfter(low);
+        double last = pricer.MultiplierAfter(high);
+        collect(group.entries, std::min(first, last), std::max(first, last));
+    }
+
+    std::sort(slots.begin(), slots.end());
+    return slots;
+}
@@ -0,0 +1,124 @@
+#include "PriceSelection.hpp"
+#include "CarStore.hpp"
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+namespace
+{
+    // Cars priced in one go; small enough that the prices stay in L1.
+    constexpr std::size_t kBatchSize = 1024;
+
+    // Whether a should be listed before b.
+    struct Before
+    {
+        PriceOrder order;
+
+        bool operator()(const PricedSlot &a, const PricedSlot &b) const
+        {
+            if (a.price != b.price)
+            {
+                return order == PriceOrder::Cheapest ? a.price < b.price : a.price > b.price;
+            }
+            return a.slot < b.slot;
+        }
+    };
+
+    // Keeps the best k cars of slots [begin, end) in a heap with the worst of them on top.
+    void SelectPiece(const CarStore &store, const DepreciationPricer &pricer, std::size_t k,
+                     std::chrono::system_clock::time_point currentTime, Before before,
+                     std::size_t begin, std::size_t end, std::vector<PricedSlot> &heap)
+    {
+        heap.reserve(k);
+        double prices[kBatchSize];
+        const std::uint64_t *soldBits = store.SoldBits().data();
+
+        // begin is a multiple of 64 and so is every batch start, so batches cover whole bitmap words.
+        for (std::size_t batch = begin; batch < end; batch += kBatchSize)
+        {
+            std::size_t count = std::min(kBatchSize, end - batch);
+            pricer.Prices(store.AddTimes().data() + batch, store.InitialPrices().data() + batch, count, currentTime, prices);
+
+            for (std::size_t offset = 0; offset < count; offset += 64)
+            {
+                std::uint64_t bits = ~soldBits[(batch + offset) / 64];
+                if (count - offset < 64)
+                {
+                    bits &= (std::uint64_t(1) << (count - offset)) - 1;
+                }
+
+                for (; bits != 0; bits &= bits - 1)
+                {
+                    std::size_t index = offset + LowestSetBit(bits);
+                    PricedSlot car{batch + index, prices[index]};
+
+                    if (heap.size() < k)
+                    {
+                        heap.push_back(car);
+                        std::push_heap(heap.begin(), heap.end(), before);
+                    }
+                    else if (before(car, heap.front()))
+                    {
+                        std::pop_heap(heap.begin(), heap.end(), before);
+                        heap.back() = car;
+                        std::push_heap(heap.begin(), heap.end(), before);
+                    }
+                }
+            }
+        }
+    }
+}
+
+std::vector<PricedSlot> SelectByPrice(const CarStore &store, const DepreciationPricer &pricer, std::size_t k,
+                                      std::chrono::system_clock::time_point currentTime, PriceOrder order,
+                                      unsigned int threadCount, std::size_t minCarsPerThread)
+{
+    const std::size_t count = store.Size();
+    k = std::min(k, store.AvailableCount());
+    if (k == 0)
+    {
+        return {};
+    }
+
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::size_t pieces = std::min<std::size_t>(threadCount, count / std::max<std::size_t>(minCarsPerThread, 1));
+    pieces = std::max<std::size_t>(pieces, 1);
+
+    // Pieces start on whole bitmap words, so no two threads read the same word's cars.
+    std::size_t pieceSize = (count / pieces + 63) & ~std::size_t(63);
+    Before before{order};
+    std::vector<std::vector<PricedSlot>> heaps(pieces);
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < pieces; i++)
+    {
+        std::size_t begin = std::min(count, i * pieceSize);
+        std::size_t end = (i + 1 == pieces) ? count : std::min(count, begin + pieceSize);
+        workers.emplace_back(SelectPiece, std::cref(store), std::cref(pricer), k, currentTime, before,
+                             begin, end, std::ref(heaps[i]));
+    }
+    SelectPiece(store, pricer, k, currentTime, before, 0, std::min(count, pieceSize), heaps[0]);
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    // At most pieces * k candidates left; keep the best k and sort only those.
+    std::vector<PricedSlot> best = std::move(heaps[0]);
+    for (std::size_t i = 1; i < pieces; i++)
+    {
+        best.insert(best.end(), heaps[i].begin(), heaps[i].end());
+    }
+    if (best.size() > k)
+    {
+        std::nth_element(best.begin(), best.begin() + k, best.end(), before);
+        best.resize(k);
+    }
+    std::sort(best.begin(), best.end(), before);
+    return best;
+}
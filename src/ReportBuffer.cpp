@@ -0,0 +1,70 @@
+#include "ReportBuffer.hpp"
+#include <charconv>
+#include <sstream>
+
+void ReportBuffer::UseFloatFormatOf(const std::ostream &out)
+{
+    const std::ios_base::fmtflags floatField = out.flags() & std::ios_base::floatfield;
+    _flags = out.flags();
+    _precision = out.precision();
+    _locale = out.getloc();
+    _useStream = (_flags & (std::ios_base::showpoint | std::ios_base::uppercase | std::ios_base::showpos)) ||
+                 floatField == (std::ios_base::fixed | std::ios_base::scientific) ||
+                 _locale != std::locale::classic();
+}
+
+void ReportBuffer::AppendThroughStream(double value)
+{
+    std::ostringstream stream;
+    stream.imbue(_locale);
+    stream.flags(_flags);
+    stream.precision(_precision);
+    stream << value;
+    Append(stream.str());
+}
+
+ReportBuffer &ReportBuffer::Append(unsigned long long value)
+{
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    _text.append(digits, result.ptr);
+    return *this;
+}
+
+ReportBuffer &ReportBuffer::Append(double value)
+{
+    if (_useStream)
+    {
+        AppendThroughStream(value);
+        return *this;
+    }
+
+    // Same rules as operator<< (printf %f, %e or %g with the stream's precision).
+    std::chars_format format = std::chars_format::general;
+    int precision = static_cast<int>(_precision);
+    const std::ios_base::fmtflags floatField = _flags & std::ios_base::floatfield;
+
+    if (floatField == std::ios_base::fixed)
+    {
+        format = std::chars_format::fixed;
+    }
+    else if (floatField == std::ios_base::scientific)
+    {
+        format = std::chars_format::scientific;
+    }
+
+    char digits[512]; // enough for any fixed double with a sane precision
+    auto result = std::to_chars(digits, digits + sizeof(digits), value, format, precision);
+    if (result.ec != std::errc())
+    {
+        result = std::to_chars(digits, digits + sizeof(digits), value);
+    }
+    _text.append(digits, result.ptr);
+    return *this;
+}
+
+void ReportBuffer::WriteTo(std::ostream &out) const
+{
+    out.write(_text.data(), static_cast<std::streamsize>(_text.size()));
+    out.flush();
+}
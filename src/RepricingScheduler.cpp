@@ -0,0 +1,83 @@
+#include "RepricingScheduler.hpp"
+#include "CarStore.hpp"
+#include <algorithm>
+
+void RepricingScheduler::Schedule(std::size_t slot, std::chrono::system_clock::time_point addTime,
+                                  const DepreciationPricer &pricer)
+{
+    auto next = pricer.NextChange(addTime, _now);
+
+    if (next != std::chrono::system_clock::time_point::max())
+    {
+        _queue.push_back({next.time_since_epoch().count(), slot});
+        std::push_heap(_queue.begin(), _queue.end(), Later());
+    }
+}
+
+void RepricingScheduler::Add(std::size_t slot, double initialPrice, std::chrono::system_clock::time_point addTime,
+                             const DepreciationPricer &pricer)
+{
+    if (!_valid)
+    {
+        return;
+    }
+
+    _prices.resize(slot + 1);
+    _prices[slot] = pricer.Price(initialPrice, addTime, _now);
+    Schedule(slot, addTime, pricer);
+}
+
+std::size_t RepricingScheduler::AdvanceTo(const CarStore &store, const DepreciationPricer &pricer,
+                                          std::chrono::system_clock::time_point currentTime)
+{
+    if (!_valid || currentTime < _now)
+    {
+        // Start over: one vectorized pass for the prices, then one heap build.
+        _now = currentTime;
+        _prices.resize(store.Size());
+        pricer.Prices(store.AddTimes().data(), store.InitialPrices().data(), store.Size(), currentTime, _prices.data());
+
+        _queue.clear();
+        store.ForEachAvailable([&](std::size_t slot)
+                               {
+                                   auto next = pricer.NextChange(store.GetAddTime(slot), currentTime);
+                                   if (next != std::chrono::system_clock::time_point::max())
+                                   {
+                                       _queue.push_back({next.time_since_epoch().count(), slot});
+                                   } });
+        std::make_heap(_queue.begin(), _queue.end(), Later());
+
+        _valid = true;
+        return store.AvailableCount();
+    }
+
+    _now = currentTime;
+    const auto now = currentTime.time_since_epoch().count();
+    std::size_t repriced = 0;
+
+    while (!_queue.empty() && _queue.front().time <= now)
+    {
+        std::size_t slot = _queue.front().slot;
+        std::pop_heap(_queue.begin(), _queue.end(), Later());
+        _queue.pop_back();
+
+        // Sold cars keep their sale price in the store; just let them go.
+        if (store.IsSold(slot))
+        {
+            continue;
+        }
+
+        _prices[slot] = pricer.Price(store.GetInitialPrice(slot), store.GetAddTime(slot), currentTime);
+        Schedule(slot, store.GetAddTime(slot), pricer);
+        repriced++;
+    }
+
+    return repriced;
+}
+
+void RepricingScheduler::Invalidate()
+{
+    _valid = false;
+    _queue.clear();
+    _prices.clear();
+}
@@ -0,0 +1,66 @@
+#include "Snapshot.hpp"
+#include <cstring>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+void Snapshot::Checksum::Update(const void *data, std::size_t size)
+{
+    const char *bytes = static_cast<const char *>(data);
+
+    for (std::size_t i = 0; i + 8 <= size; i += 8)
+    {
+        std::uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        _hash = (_hash ^ word) * 0x100000001b3ull;
+        _hash ^= _hash >> 29;
+    }
+}
+
+bool Snapshot::SyncFile(const std::string &filename)
+{
+#ifdef _WIN32
+    int file = _open(filename.c_str(), _O_RDWR | _O_BINARY);
+    if (file < 0)
+    {
+        return false;
+    }
+    bool synced = _commit(file) == 0;
+    _close(file);
+    return synced;
+#else
+    int file = open(filename.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+    bool synced = fsync(file) == 0;
+    close(file);
+    return synced;
+#endif
+}
+
+bool Snapshot::SyncParentDirectory(const std::string &filename)
+{
+#ifdef _WIN32
+    (void)filename;
+    return true;
+#else
+    std::size_t slash = filename.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : filename.substr(0, slash));
+
+    int file = open(directory.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+    bool synced = fsync(file) == 0;
+    close(file);
+    return synced;
+#endif
+}
@@ -0,0 +1,48 @@
+#include "StringArena.hpp"
+#include <cstring>
+
+void StringArena::AddBlock(std::size_t size)
+{
+    // new char[] leaves the memory untouched, so unused parts of a block cost no RSS.
+    _blocks.emplace_back(new char[size]);
+    _cursor = _blocks.back().get();
+    _left = size;
+    _allocated += size;
+}
+
+std::string_view StringArena::Store(std::string_view text)
+{
+    if (text.empty())
+    {
+        return std::string_view();
+    }
+
+    if (text.size() > _left)
+    {
+        AddBlock(text.size() > _blockSize ? text.size() : _blockSize);
+    }
+
+    char *copy = _cursor;
+    std::memcpy(copy, text.data(), text.size());
+    _cursor += text.size();
+    _left -= text.size();
+    _used += text.size();
+    return std::string_view(copy, text.size());
+}
+
+void StringArena::Reserve(std::size_t bytes)
+{
+    if (bytes > _left)
+    {
+        AddBlock(bytes > _blockSize ? bytes : _blockSize);
+    }
+}
+
+void StringArena::Clear()
+{
+    _blocks.clear();
+    _cursor = nullptr;
+    _left = 0;
+    _used = 0;
+    _allocated = 0;
+}
@@ -1,26 +1,27 @@
 #include "car.hpp"
+#include "Depreciation.hpp"
 #include <iostream>
-#include <algorithm>
 
 double Car::CalculateCurrentPrice(std::chrono::system_clock::time_point currentTime) const{
 
-    auto elapsed_seconds = std::chrono::duration_cast<std::chrono::seconds>(currentTime - _addTime).count();
-    double discount=0;
-
-    if(elapsed_seconds>30&&elapsed_seconds<40){
-        discount=0.001;
-    }
-    else if (elapsed_seconds>=40)
-    {
-        int times=(elapsed_seconds-30)/10;
-        discount=0.001+0.001*times;
-    }
-    else return _initialPrice;
-
-    discount=std::min(discount,0.20);
-    return _initialPrice*(1.0-discount);
+    return CalculatePrice(_initialPrice, _addTime, currentTime);
 }
 
+double Car::CalculatePrice(double initialPrice, std::chrono::system_clock::time_point addTime,
+                           std::chrono::system_clock::time_point currentTime){
+
+    // One lookup in the compile-time table of the default rule.
+    return DepreciatedPrice(kDefaultMultiplierTable, initialPrice, addTime, currentTime);
+}
+
+
+CAR_PRICE_KERNEL_CLONES
+void Car::CalculatePrices(const std::chrono::system_clock::rep *addTimes, const double *initialPrices,
+                          std::size_t count, std::chrono::system_clock::time_point currentTime,
+                          double *prices){
+
+    DepreciatedPrices(kDefaultMultiplierTable, addTimes, initialPrices, count, currentTime, prices);
+}
 
 void Car::ShowCarInfo(std::chrono::system_clock::time_point currentTime) const{
 
@@ -4,8 +4,10 @@
 #include <cctype>         // For std::toupper
 #include <cstddef>        // For size_t
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <cstdlib>         // system()
+#include <iomanip>         // std::setprecision
 
 
 void clear_console() {
@@ -22,11 +24,56 @@ void clear_console() {
 #endif
 }
 
+// Prints what the car manager does to the console.
+class ConsoleEventSink : public InventoryEventSink
+{
+public:
+    void CarAdded(unsigned int id, std::string_view model, unsigned int registerYear, double initialPrice) override
+    {
+        std::cout << "Car added: ID " << id << " (" << model << " " << registerYear << ") Initial Price: " << initialPrice << "\n";
+    }
+
+    void SaleAttempted(const SaleResult &result, std::string_view model) override
+    {
+        switch (result.status)
+        {
+        case SaleStatus::Sold:
+            std::cout << "Success: Car with ID " << result.id << " (" << model
+                      << ") sold for " << std::fixed << std::setprecision(2) << result.salePrice << "." << std::endl;
+            break;
+        case SaleStatus::AlreadySold:
+            std::cout << "Car already sold!!\n";
+            break;
+        case SaleStatus::NotFound:
+            std::cout << "Wrong Car ID\n";
+            break;
+        }
+    }
+
+    void LineSkipped(std::size_t lineNumber, std::string_view line, std::string_view error) override
+    {
+        std::cerr << "Error parsing line " << lineNumber << ": '" << line << "'. Error: " << error << ". Skipping line." << std::endl;
+    }
+
+    void Message(EventLevel level, std::string_view text) override
+    {
+        if (level == EventLevel::Error)
+        {
+            std::cerr << "Error: " << text << std::endl;
+        }
+        else
+        {
+            std::cout << (level == EventLevel::Warning ? "Warning: " : "") << text << std::endl;
+        }
+    }
+};
+
 void print_menu()
 {
     std::cout << "\n--- Car Dealership System Menu ---\n";
     std::cout << "----------------------------------\n";
     std::cout << " A - Show Available Cars\n";
+    std::cout << " F - Find Available Cars by Model\n";
     std::cout << " R - Show Daily Report\n";
     std::cout << " L - Load Cars from File\n";
     std::cout << " W - Save Cars to File\n";
@@ -39,13 +86,21 @@ void print_menu()
 int main()
 {
     CarManager MainCarManager;
+    ConsoleEventSink consoleEvents;
+    MainCarManager.SetEventSink(&consoleEvents);
     char option = ' ';
 
-    // Define the path to the data file
+    // Define the paths to the data files
     const std::string data_filename = "../resources/CarsDB.csv";
+    const std::string snapshot_filename = "../resources/CarsDB.snap";
+    const std::string journal_filename = "../resources/CarsDB.journal";
 
-    // Attempt to load data automatically on startup
-    MainCarManager.LoadFromFile(data_filename);
+    // Attempt to load data automatically on startup: the binary snapshot plus the
+    // changes journaled since then, or the text file when there is neither
+    if (!MainCarManager.OpenJournal(snapshot_filename, journal_filename))
+    {
+        MainCarManager.LoadFromFile(data_filename);
+    }
 
     while (true) // Loop until user chooses to exit
     {
@@ -79,6 +134,15 @@ int main()
             }
             break;
 
+        case 'F': // Find Available Cars by Model
+        {
+            std::cout << "Model (or its beginning): ";
+            std::string modelPrefix;
+            std::getline(std::cin >> std::ws, modelPrefix);
+            MainCarManager.ShowAvailableCarsByModel(modelPrefix);
+        }
+        break;
+
         case 'R': // Show Daily Report
             if (MainCarManager.GetCarCount() > 0)
             {
@@ -214,8 +278,10 @@ int main()
         // Exit the loop if the user chose 'X'
         if (option == 'X')
         {
+            // The text file is what 'L' loads, so it has to stay current too.
             std::cout << "Saving inventory before exiting..." << std::endl;
             MainCarManager.SaveToFile(data_filename);
+            MainCarManager.CompactJournal();
             std::cout << "Exiting Car Dealership System. Goodbye!" << std::endl;
             break;
         }
@@ -0,0 +1,88 @@
+// test/car_csv_test.cpp
+
+#include "doctest.h"
+#include "CarCsv.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+
+TEST_SUITE("Car CSV Parsing Tests") {
+
+    TEST_CASE("ParseCarLine reads a full line") {
+        CarRecord record;
+        const char* error = ParseCarLine("2;Toyota Corolla;2020;62000.00;1;60500.00", record);
+
+        REQUIRE(error == nullptr);
+        CHECK(record.id == 2);
+        CHECK(record.model == "Toyota Corolla");
+        CHECK(record.registerYear == 2020);
+        CHECK(record.initialPrice == doctest::Approx(62000.0));
+        CHECK(record.isSold == true);
+        CHECK(record.salePrice == doctest::Approx(60500.0));
+    }
+
+    TEST_CASE("ParseCarLine handles optional and broken sale price") {
+        CarRecord record;
+
+        CHECK(ParseCarLine("1;Skoda Octavia;2018;45000.00;0", record) == nullptr);
+        CHECK(record.isSold == false);
+        CHECK(record.salePrice == 0.0);
+
+        CHECK(ParseCarLine("1;Skoda Octavia;2018;45000.00;1;abc", record) == nullptr);
+        CHECK(record.salePrice == 0.0);
+
+        CHECK(ParseCarLine("1;Skoda Octavia;2018;45000.00;1;31800.50\r", record) == nullptr);
+        CHECK(record.salePrice == doctest::Approx(31800.50));
+    }
+
+    TEST_CASE("ParseCarLine reports missing and invalid fields") {
+        CarRecord record;
+
+        CHECK(std::string_view(ParseCarLine("", record)) == "Missing ID");
+        CHECK(std::string_view(ParseCarLine("x;Opel;2018;1;0;0", record)) == "Invalid ID");
+        CHECK(std::string_view(ParseCarLine("1", record)) == "Missing Model");
+        CHECK(std::string_view(ParseCarLine("1;Opel", record)) == "Missing Register Year");
+        CHECK(std::string_view(ParseCarLine("1;Opel;2018", record)) == "Missing Initial Price");
+        CHECK(std::string_view(ParseCarLine("1;Opel;2018;cheap;0", record)) == "Invalid Initial Price");
+        CHECK(std::string_view(ParseCarLine("1;Opel;2018;100", record)) == "Missing IsSold status");
+    }
+
+    TEST_CASE("ParseCarCsv gives the same result with many threads") {
+        std::string text;
+        for (int i = 1; i <= 200; i++) {
+            if (i % 50 == 0) {
+                text += "broken line\n";
+            }
+            text += std::to_string(i) + ";Model " + std::to_string(i % 7) + ";2020;1000;0;0\n";
+        }
+
+        auto serial = ParseCarCsv(text, 1);
+        auto parallel = ParseCarCsv(text, 4, 1);
+
+        REQUIRE(serial.size() == 1);
+        CHECK(parallel.size() == 4);
+
+        std::vector<unsigned int> ids;
+        std::vector<std::size_t> errorLines;
+        std::size_t firstLine = 0;
+        for (const auto& chunk : parallel) {
+            for (const auto& record : chunk.records) {
+                ids.push_back(record.id);
+            }
+            for (const auto& error : chunk.errors) {
+                errorLines.push_back(firstLine + error.lineNumber);
+            }
+            firstLine += chunk.lineCount;
+        }
+
+        CHECK(firstLine == serial[0].lineCount);
+        REQUIRE(ids.size() == serial[0].records.size());
+        for (std::size_t i = 0; i < ids.size(); i++) {
+            CHECK(ids[i] == serial[0].records[i].id);
+        }
+        REQUIRE(errorLines.size() == 4);
+        for (std::size_t i = 0; i < errorLines.size(); i++) {
+            CHECK(errorLines[i] == serial[0].errors[i].lineNumber);
+        }
+    }
+}
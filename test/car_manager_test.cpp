@@ -2,9 +2,16 @@
 
 #include "doctest.h" 
 #include "../include/CarManager.hpp"  
+#include "../include/Snapshot.hpp"
 #include <string> 
 #include <vector> 
 #include <memory> 
+#include <fstream>
+#include <cstdio>
+#include <sstream>
+#include <iomanip>
+#include <random>
+#include <cmath>
 
 
 TEST_SUITE("CarManager Simple Tests") {
@@ -71,7 +78,694 @@ TEST_SUITE("CarManager Simple Tests") {
         CarManager manager; 
         manager.LoadFromFile("i_do_not_exist.csv");
         CHECK(manager.GetCarCount() == 0);
+
+        // A missing file leaves what is already there alone.
+        manager.AddCar("Opel Astra", 2020, 10000.0);
+        manager.LoadFromFile("i_do_not_exist.csv");
+        CHECK(manager.GetCarCount() == 1);
+        CHECK(manager.GetNextCarId() == 2);
+    }
+
+    TEST_CASE("GetAvailableCount and GetSoldCount follow sales and loads") {
+        CarManager manager;
+        manager.AddCar("Opel Astra", 2018, 45000.0);
+        manager.AddCar("Ford Focus", 2019, 51000.0);
+        manager.AddCar("Kia Ceed", 2021, 70000.0);
+        manager.SellCar(2);
+
+        CHECK(manager.GetSoldCount() == 1);
+        CHECK(manager.GetAvailableCount() == 2);
+
+        const char* snapshot = "counts_test.snap";
+        manager.SaveSnapshot(snapshot);
+        CarManager restored;
+        restored.LoadSnapshot(snapshot);
+        std::remove(snapshot);
+
+        CHECK(restored.GetSoldCount() == 1);
+        CHECK(restored.GetAvailableCount() == 2);
+        CHECK(restored.IsCarSold(2) == true);
+    }
+
+
+    TEST_CASE("LoadFromFile skips broken lines and keeps the rest") {
+        const char* path = "broken_lines_test.csv";
+        {
+            std::ofstream out(path);
+            out << "1;Skoda Octavia;2018;45000.00;0;0.00\r\n";
+            out << "oops\n";
+            out << "2;Toyota Corolla;2020;62000.00;1;60500.00";
+        }
+
+        CarManager manager;
+        manager.LoadFromFile(path);
+        std::remove(path);
+
+        CHECK(manager.GetCarCount() == 2);
+        CHECK(manager.GetNextCarId() == 3);
+        CHECK(manager.IsCarSold(2) == true);
+    }
+
+
+    TEST_CASE("SaveSnapshot and LoadSnapshot round trip the inventory") {
+        const char* path = "snapshot_test.snap";
+        CarManager original;
+        original.AddCar("Opel Astra", 2018, 45000.0);
+        original.AddCar("Ford Focus", 2019, 51000.0);
+        original.AddCar("Mercedes-Benz C200", 2021, 150000.0);
+        original.SellCar(2);
+        CHECK(original.SaveSnapshot(path) == true);
+        CHECK(Snapshot::SyncFile(path));
+        CHECK(Snapshot::SyncParentDirectory(path));
+        CHECK_FALSE(Snapshot::SyncFile("i_do_not_exist.snap"));
+        CHECK_FALSE(original.SaveSnapshot("no_such_directory/snapshot_test.snap"));
+
+        CarManager restored;
+        CHECK(restored.LoadSnapshot(path) == true);
+        std::remove(path);
+
+        CHECK(restored.GetCarCount() == 3);
+        CHECK(restored.GetNextCarId() == 4);
+        CHECK(restored.IsCarSold(1) == false);
+        CHECK(restored.IsCarSold(2) == true);
+        CHECK(restored.SellCar(3) == true);
+    }
+
+    TEST_CASE("SaveSnapshot and LoadSnapshot round trip an empty inventory") {
+        const char* path = "empty_snapshot_test.snap";
+        CarManager empty;
+        CHECK(empty.SaveSnapshot(path) == true);
+
+        CarManager restored;
+        restored.AddCar("Replaced", 2020, 1000.0);
+        CHECK(restored.LoadSnapshot(path) == true);
+        std::remove(path);
+
+        CHECK(restored.GetCarCount() == 0);
+        CHECK(restored.GetNextCarId() == 1);
+        CHECK(restored.AddCar("Opel Astra", 2018, 45000.0) == 1);
+    }
+
+    TEST_CASE("LoadSnapshot rejects missing and damaged files") {
+        const char* path = "damaged_test.snap";
+        CarManager manager;
+        manager.AddCar("Keep Me", 2020, 1000.0);
+
+        CHECK(manager.LoadSnapshot("i_do_not_exist.snap") == false);
+
+        manager.SaveSnapshot(path);
+        {
+            std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp(-1, std::ios::end);
+            file.put('X');
+        }
+        CHECK(manager.LoadSnapshot(path) == false);
+
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            file << "not a snapshot";
+        }
+        CHECK(manager.LoadSnapshot(path) == false);
+        std::remove(path);
+
+        CHECK(manager.GetCarCount() == 1);
+    }
+
+
+    TEST_CASE("Journal restores changes made after the last snapshot") {
+        const char* snapshot = "journal_test.snap";
+        const char* journal = "journal_test.journal";
+        std::remove(snapshot);
+        std::remove(journal);
+
+        {
+            CarManager manager;
+            CHECK(manager.OpenJournal(snapshot, journal) == false);
+            manager.AddCar("Opel Astra", 2018, 45000.0);
+            manager.AddCar("Ford Focus", 2019, 51000.0);
+            manager.CompactJournal();
+            manager.AddCar("Honda Civic", 2022, 85000.0);
+            manager.SellCar(2);
+            CHECK(manager.SyncJournal());
+        }
+        CHECK_FALSE(Journal().Sync()); // nothing open to sync
+
+        // Simulate a record that was only half written when the program died.
+        {
+            std::ofstream out(journal, std::ios::binary | std::ios::app);
+            out << "torn";
+        }
+
+        {
+            struct WarningSink : InventoryEventSink {
+                std::vector<std::string> warnings;
+                void Message(EventLevel level, std::string_view text) override {
+                    if (level == EventLevel::Warning) {
+                        warnings.emplace_back(text);
+                    }
+                }
+            };
+
+            WarningSink sink;
+            CarManager manager;
+            manager.SetEventSink(&sink);
+            CHECK(manager.OpenJournal(snapshot, journal) == true);
+            REQUIRE(sink.warnings.size() == 1);
+            CHECK(sink.warnings[0].find("Dropping damaged journal tail") != std::string::npos);
+            CHECK(manager.GetCarCount() == 3);
+            CHECK(manager.GetNextCarId() == 4);
+            CHECK(manager.IsCarSold(2) == true);
+            CHECK(manager.IsCarSold(3) == false);
+            manager.SellCar(3);
+        }
+
+        {
+            CarManager manager;
+            CHECK(manager.OpenJournal(snapshot, journal) == true);
+            CHECK(manager.GetCarCount() == 3);
+            CHECK(manager.IsCarSold(3) == true);
+            manager.CompactJournal();
+        }
+
+        CarManager fromSnapshotOnly;
+        CHECK(fromSnapshotOnly.LoadSnapshot(snapshot) == true);
+        CHECK(fromSnapshotOnly.GetCarCount() == 3);
+        CHECK(fromSnapshotOnly.IsCarSold(3) == true);
+
+        std::remove(snapshot);
+        std::remove(journal);
+    }
+
+    TEST_CASE("Journal compacts itself after enough changes") {
+        const char* snapshot = "journal_compact_test.snap";
+        const char* journal = "journal_compact_test.journal";
+        std::remove(snapshot);
+        std::remove(journal);
+
+        {
+            CarManager manager;
+            manager.OpenJournal(snapshot, journal);
+            manager.SetJournalCompactionThreshold(5);
+            for (int i = 0; i < 7; i++) {
+                manager.AddCar("Bulk", 2020, 1000.0);
+            }
+        }
+
+        CarManager snapshotOnly;
+        CHECK(snapshotOnly.LoadSnapshot(snapshot) == true);
+        CHECK(snapshotOnly.GetCarCount() == 5);
+
+        CarManager restored;
+        restored.OpenJournal(snapshot, journal);
+        CHECK(restored.GetCarCount() == 7);
+
+        std::remove(snapshot);
+        std::remove(journal);
+    }
+
+    TEST_CASE("FindAvailableByModel matches model prefixes of available cars") {
+        const char* path = "model_search_test.csv";
+        {
+            std::ofstream out(path);
+            out << "1;Opel Astra;2018;45000.00;0;0.00\n";
+            out << "2;Opel Corsa;2019;38000.00;1;37000.00\n";
+            out << "3;Mercedes-Benz C 200;2021;150000.00;0;0.00\n";
+            out << "4;Mercedes-Benz E 300;2022;210000.00;0;0.00\n";
+            out << "5;Opel Astra;2020;52000.00;0;0.00\n";
+        }
+
+        CarManager manager;
+        manager.LoadFromFile(path);
+        std::remove(path);
+
+        CHECK(manager.FindAvailableByModel("Opel") == std::vector<unsigned int>{1, 5});
+        CHECK(manager.FindAvailableByModel("Opel Corsa").empty());
+        CHECK(manager.FindAvailableByModel("Mercedes-Benz C") == std::vector<unsigned int>{3});
+        CHECK(manager.FindAvailableByModel("opel").empty());
+        CHECK(manager.FindAvailableByModel("").size() == 4);
+
+        manager.AddCar("Opel Corsa", 2023, 61000.0);
+        CHECK(manager.FindAvailableByModel("Opel") == std::vector<unsigned int>{1, 5, 6});
+
+        manager.SellCar(1);
+        manager.SellCar(6);
+        CHECK(manager.FindAvailableByModel("Opel") == std::vector<unsigned int>{5});
+        CHECK(manager.FindAvailableByModel("Opel Corsa").empty());
+
+        const char* snapshot = "model_search_test.snap";
+        manager.SaveSnapshot(snapshot);
+        CarManager restored;
+        restored.LoadSnapshot(snapshot);
+        std::remove(snapshot);
+        CHECK(restored.FindAvailableByModel("Opel") == std::vector<unsigned int>{5});
+        CHECK(restored.FindAvailableByModel("Mercedes") == std::vector<unsigned int>{3, 4});
+    }
+
+    TEST_CASE("ShowDailyReport prints the same text as field by field output") {
+        CarManager manager;
+        manager.AddCar("Opel Astra", 2018, 45000.0);
+        manager.AddCar("Ford Focus", 2019, 12345.678);
+        manager.AddCar("Kia Ceed", 2021, 70000.5);
+        manager.SellCar(2);
+
+        auto expected = [&](std::ostringstream &out) {
+            struct Row { unsigned int id; const char *model; unsigned int year; double price; bool sold; };
+            Row rows[] = {{1, "Opel Astra", 2018, 45000.0, false}, {2, "Ford Focus", 2019, 12345.678, true}, {3, "Kia Ceed", 2021, 70000.5, false}};
+            out << "----------- Day Report ---------\n";
+            out << "----------- Sold Cars ---------\n";
+            for (bool sold : {true, false}) {
+                if (!sold) {
+                    out << "----------- Not Sold Cars ---------\n";
+                }
+                for (const Row &row : rows) {
+                    if (row.sold == sold) {
+                        out << "ID: " << row.id << "\n" << "Model: " << row.model << "\n" << "Register Year: " << row.year << "\n"
+                            << "Sell Price: " << row.price << "\n" << "Status: " << (row.sold ? "Sold" : "Available") << "\n"
+                            << "----------------------\n";
+                    }
+                }
+            }
+            out << "Summary: Sold - " << 1 << ", Available - " << 2 << "\n";
+            out << "----------------------------------\n";
+        };
+
+        std::ostringstream plain, plainExpected;
+        manager.ShowDailyReport(plain);
+        expected(plainExpected);
+        CHECK(plain.str() == plainExpected.str());
+
+        std::ostringstream fixed, fixedExpected;
+        fixed << std::fixed << std::setprecision(2);
+        fixedExpected << std::fixed << std::setprecision(2);
+        manager.ShowDailyReport(fixed);
+        expected(fixedExpected);
+        CHECK(fixed.str() == fixedExpected.str());
+    }
+
+    TEST_CASE("ShowAvailableCars writes the available cars to a stream") {
+        CarManager manager;
+        manager.AddCar("Opel Astra", 2018, 45000.0);
+        manager.AddCar("Ford Focus", 2019, 12345.678);
+        manager.SellCar(1);
+
+        // Within the grace period the actual price is still the initial one.
+        std::ostringstream out, expected;
+        out << std::fixed << std::setprecision(2);
+        expected << std::fixed << std::setprecision(2);
+        manager.ShowAvailableCars(out);
+        expected << "--- Available Cars ---\n"
+                 << "ID: " << 2 << "\n" << "Model: Ford Focus\n" << "Register Year: " << 2019 << "\n"
+                 << "Actual Price: " << 12345.678 << "\n" << "Status: Available\n"
+                 << "----------------------\n";
+        CHECK(out.str() == expected.str());
+
+        manager.SellCar(2);
+        std::ostringstream empty;
+        manager.ShowAvailableCars(empty);
+        CHECK(empty.str() == "--- Available Cars ---\nNo cars currently available for sale.\n");
+    }
+
+    TEST_CASE("ShowAvailableCarsByModel writes the matching cars to a stream") {
+        CarManager manager;
+        manager.AddCar("Opel Astra", 2018, 45000.0);
+        manager.AddCar("Ford Focus", 2019, 12345.678);
+        manager.AddCar("Opel Corsa", 2020, 30000.5);
+        manager.SellCar(1);
+
+        std::ostringstream out, expected;
+        out << std::fixed << std::setprecision(2);
+        expected << std::fixed << std::setprecision(2);
+        manager.ShowAvailableCarsByModel(out, "Opel");
+        expected << "--- Available Cars: Opel ---\n"
+                 << "ID: " << 3 << "\n" << "Model: Opel Corsa\n" << "Register Year: " << 2020 << "\n"
+                 << "Actual Price: " << 30000.5 << "\n" << "Status: Available\n"
+                 << "----------------------\n";
+        CHECK(out.str() == expected.str());
+
+        std::ostringstream none;
+        manager.ShowAvailableCarsByModel(none, "Kia");
+        CHECK(none.str() == "--- Available Cars: Kia ---\nNo available cars match \"Kia\".\n");
+    }
+
+    TEST_CASE("GetStatistics follows adds, sales and loads") {
+        const char* path = "statistics_test.csv";
+        {
+            std::ofstream out(path);
+            out << "1;Opel Astra;2018;45000.00;0;0.00\n";
+            out << "2;Toyota Corolla;2020;62000.00;1;60500.00\n";
+            out << "3;Kia Ceed;2021;70000.00;1;69000.00\n";
+        }
+
+        CarManager manager;
+        manager.LoadFromFile(path);
+        std::remove(path);
+
+        InventoryStatistics loaded = manager.GetStatistics();
+        CHECK(loaded.soldCount == 2);
+        CHECK(loaded.availableCount == 1);
+        CHECK(loaded.totalRevenue == doctest::Approx(129500.0));
+        CHECK(loaded.totalListedValue == doctest::Approx(45000.0));
+        CHECK(loaded.totalDiscount == doctest::Approx(2500.0));
+
+        manager.AddCar("Ford Focus", 2019, 51000.0);
+        manager.SellCar(1); // sold right away, so at the full price
+        InventoryStatistics changed = manager.GetStatistics();
+        CHECK(changed.soldCount == 3);
+        CHECK(changed.availableCount == 1);
+        CHECK(changed.totalRevenue == doctest::Approx(174500.0));
+        CHECK(changed.totalListedValue == doctest::Approx(51000.0));
+        CHECK(changed.totalDiscount == doctest::Approx(2500.0));
+
+        const char* snapshot = "statistics_test.snap";
+        manager.SaveSnapshot(snapshot);
+        CarManager restored;
+        restored.LoadSnapshot(snapshot);
+        std::remove(snapshot);
+
+        InventoryStatistics fromSnapshot = restored.GetStatistics();
+        CHECK(fromSnapshot.soldCount == 3);
+        CHECK(fromSnapshot.totalRevenue == doctest::Approx(174500.0));
+        CHECK(fromSnapshot.totalListedValue == doctest::Approx(51000.0));
+    }
+
+    TEST_CASE("GetStatistics lists exactly nothing once every car is sold") {
+        CarManager manager;
+        for (int i = 0; i < 1000; i++) {
+            manager.AddCar("Bulk", 2020, 99999.99 + i * 0.37);
+        }
+        for (unsigned int id = 1000; id >= 1; id--) {
+            manager.SellCar(id);
+        }
+
+        InventoryStatistics statistics = manager.GetStatistics();
+        CHECK(statistics.availableCount == 0);
+        CHECK(statistics.totalListedValue == 0.0);
+        CHECK_FALSE(std::signbit(statistics.totalListedValue));
+    }
+
+    TEST_CASE("AddCars and SellCars work on whole batches") {
+        CarManager manager;
+        manager.AddCar("Opel Astra", 2018, 45000.0);
+
+        std::vector<CarSpec> batch = {{"Ford Focus", 2019, 51000.0}, {"Kia Ceed", 2021, 70000.0}, {"Opel Corsa", 2020, 38000.0}};
+        std::vector<unsigned int> ids = manager.AddCars(batch);
+
+        CHECK(ids == std::vector<unsigned int>{2, 3, 4});
+        CHECK(manager.GetCarCount() == 4);
+        CHECK(manager.GetNextCarId() == 5);
+        CHECK(manager.FindAvailableByModel("Opel") == std::vector<unsigned int>{1, 4});
+
+        std::vector<SaleResult> results = manager.SellCars({3, 99, 3, 1});
+        REQUIRE(results.size() == 4);
+        CHECK(results[0].id == 3);
+        CHECK(results[0].status == SaleStatus::Sold);
+        CHECK(results[0].salePrice == doctest::Approx(70000.0));
+        CHECK(results[1].status == SaleStatus::NotFound);
+        CHECK(results[2].status == SaleStatus::AlreadySold);
+        CHECK(results[3].status == SaleStatus::Sold);
+
+        CHECK(manager.IsCarSold(3) == true);
+        CHECK(manager.GetSoldCount() == 2);
+        CHECK(manager.GetStatistics().totalRevenue == doctest::Approx(115000.0));
+        CHECK(manager.FindAvailableByModel("Opel") == std::vector<unsigned int>{4});
+        CHECK(manager.AddCars({}).empty());
+    }
+
+    TEST_CASE("Batches are journaled and restored") {
+        const char* snapshot = "batch_journal_test.snap";
+        const char* journal = "batch_journal_test.journal";
+        std::remove(snapshot);
+        std::remove(journal);
+
+        {
+            CarManager manager;
+            manager.OpenJournal(snapshot, journal);
+            std::vector<CarSpec> batch(50, CarSpec{"Bulk", 2020, 1000.0});
+            manager.AddCars(batch);
+            manager.SellCars({5, 10, 15});
+        }
+
+        CarManager restored;
+        restored.OpenJournal(snapshot, journal);
+        CHECK(restored.GetCarCount() == 50);
+        CHECK(restored.GetSoldCount() == 3);
+        CHECK(restored.IsCarSold(10) == true);
+        CHECK(restored.GetNextCarId() == 51);
+
+        std::remove(snapshot);
+        std::remove(journal);
+    }
+
+    TEST_CASE("CarManager reports adds, sales and load problems to its event sink") {
+        struct RecordingSink : InventoryEventSink {
+            std::vector<unsigned int> added;
+            std::vector<SaleResult> sales;
+            std::vector<std::string> models;
+            std::vector<std::size_t> skippedLines;
+            std::vector<std::string> warnings;
+
+            void CarAdded(unsigned int id, std::string_view, unsigned int, double) override { added.push_back(id); }
+            void SaleAttempted(const SaleResult &result, std::string_view model) override {
+                sales.push_back(result);
+                models.emplace_back(model);
+            }
+            void LineSkipped(std::size_t lineNumber, std::string_view, std::string_view) override { skippedLines.push_back(lineNumber); }
+            void Message(EventLevel level, std::string_view text) override {
+                if (level == EventLevel::Warning) {
+                    warnings.emplace_back(text);
+                }
+            }
+        };
+
+        RecordingSink sink;
+        CarManager manager;
+        manager.SetEventSink(&sink);
+
+        CHECK(manager.AddCar("Opel Astra", 2018, 45000.0) == 1);
+        SaleResult sold = manager.Sell(1);
+        CHECK(sold.status == SaleStatus::Sold);
+        CHECK(sold.salePrice == doctest::Approx(45000.0));
+        CHECK(manager.SellCar(1) == false);
+        CHECK(manager.Sell(42).status == SaleStatus::NotFound);
+
+        CHECK(sink.added == std::vector<unsigned int>{1});
+        REQUIRE(sink.sales.size() == 3);
+        CHECK(sink.sales[0].status == SaleStatus::Sold);
+        CHECK(sink.sales[1].status == SaleStatus::AlreadySold);
+        CHECK(sink.sales[2].status == SaleStatus::NotFound);
+        CHECK(sink.models == std::vector<std::string>{"Opel Astra", "Opel Astra", ""});
+
+        const char* path = "event_sink_test.csv";
+        {
+            std::ofstream out(path);
+            out << "1;Skoda Octavia;2018;45000.00;0;0.00\n";
+            out << "broken\n";
+        }
+        manager.LoadFromFile(path);
+        std::remove(path);
+        manager.LoadFromFile("no_such_file.csv");
+
+        CHECK(sink.skippedLines == std::vector<std::size_t>{2});
+        REQUIRE(sink.warnings.size() == 1);
+        CHECK(sink.warnings[0] == "Could not open file for loading: no_such_file.csv.");
+
+        manager.SetEventSink(nullptr); // back to silence
+        manager.AddCar("Kia Ceed", 2021, 70000.0);
+        CHECK(sink.added.size() == 1);
     }
 
+    TEST_CASE("Model names survive a snapshot round trip through the arena") {
+        CarManager manager;
+        manager.AddCar("Opel Astra", 2020, 50000.0);
+        manager.AddCar("", 2019, 30000.0);
+        manager.AddCar("Skoda Octavia", 2018, 45000.0);
+        manager.SellCar(2);
+
+        const char* path = "arena_snapshot_test.snap";
+        REQUIRE(manager.SaveSnapshot(path));
+
+        CarManager restored;
+        REQUIRE(restored.LoadSnapshot(path));
+        std::remove(path);
+
+        CHECK(restored.GetCarCount() == 3);
+        CHECK(restored.FindAvailableByModel("Opel") == std::vector<unsigned int>{1});
+        CHECK(restored.FindAvailableByModel("Skoda") == std::vector<unsigned int>{3});
+        CHECK(restored.IsCarSold(2));
+    }
+
+    TEST_CASE("Snapshots store each model name once") {
+        const std::string model(200, 'M');
+        CarManager manager;
+        for (int i = 0; i < 1000; i++) {
+            manager.AddCar(i % 2 ? model : "Opel Astra", 2020, 50000.0);
+        }
+        manager.SellCar(2);
+
+        const char* path = "dictionary_snapshot_test.snap";
+        REQUIRE(manager.SaveSnapshot(path));
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        CHECK(static_cast<std::size_t>(file.tellg()) < 500 * model.size());
+        file.close();
+
+        CarManager restored;
+        REQUIRE(restored.LoadSnapshot(path));
+        std::remove(path);
+
+        CHECK(restored.GetCarCount() == 1000);
+        CHECK(restored.FindAvailableByModel("M").size() == 499);
+        CHECK(restored.FindAvailableByModel("Opel").size() == 500);
+        CHECK(restored.IsCarSold(2));
+    }
+
+    TEST_CASE("CarManager takes the time from its clock") {
+        ManualClock clock;
+        CarManager manager(clock);
+        manager.AddCar("Opel Astra", 2020, 100000.0);
+        manager.AddCar("Ford Focus", 2019, 50000.0);
+
+        // An hour of depreciation without waiting for it.
+        clock.Advance(std::chrono::hours(1));
+        SaleResult sold = manager.Sell(1);
+        CHECK(sold.salePrice == doctest::Approx(80000.0));
+
+        Car car(3, "Kia Ceed", 2021, 70000.0, clock);
+        CHECK(car.GetAddTime() == clock.Now());
+        CHECK(car.CalculateCurrentPrice(clock.Now()) == doctest::Approx(70000.0));
+
+        clock.Set(clock.Now() - std::chrono::hours(1));
+        CHECK(manager.Sell(2).salePrice == doctest::Approx(50000.0));
+        CHECK(&manager.GetClock() == &clock);
+    }
+
+    TEST_CASE("ShowAvailableCars follows the clock and the schedule") {
+        ManualClock clock;
+        CarManager manager(clock);
+        manager.AddCar("Opel Astra", 2020, 100000.0);
+
+        auto list = [&]() {
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(2);
+            manager.ShowAvailableCars(out);
+            return out.str();
+        };
+
+        CHECK(list().find("Actual Price: 100000.00") != std::string::npos);
+        clock.Advance(std::chrono::seconds(45));
+        CHECK(list().find("Actual Price: 99800.00") != std::string::npos);
+
+        manager.AddCar("Ford Focus", 2019, 50000.0);
+        clock.Advance(std::chrono::hours(1));
+        std::string capped = list();
+        CHECK(capped.find("Actual Price: 80000.00") != std::string::npos);
+        CHECK(capped.find("Actual Price: 40000.00") != std::string::npos);
+
+        LinearDepreciation halfOff;
+        halfOff.maxDiscount = 0.5;
+        halfOff.stepDiscount = 0.01;
+        manager.SetDepreciationSchedule(halfOff);
+        CHECK(list().find("Actual Price: 50000.00") != std::string::npos);
+
+        clock.Set(clock.Now() - std::chrono::hours(2));
+        CHECK(list().find("Actual Price: 100000.00") != std::string::npos);
+    }
+
+    TEST_CASE("FindAvailableByPrice matches pricing every car") {
+        ManualClock clock;
+        CarManager manager(clock);
+        std::vector<double> initialPrices;
+        std::vector<std::chrono::system_clock::time_point> addTimes;
+        std::mt19937 random(7);
+
+        auto expected = [&](double low, double high) {
+            std::vector<unsigned int> ids;
+            for (unsigned int id = 1; id <= initialPrices.size(); id++) {
+                double price = Car::CalculatePrice(initialPrices[id - 1], addTimes[id - 1], clock.Now());
+                if (!manager.IsCarSold(id) && price >= low && price <= high) {
+                    ids.push_back(id);
+                }
+            }
+            return ids;
+        };
+
+        int mismatches = 0;
+        for (int round = 0; round < 300; round++) {
+            for (int i = 0; i < 10; i++) {
+                double price = 30000.0 + random() % 30000;
+                addTimes.push_back(clock.Now());
+                initialPrices.push_back(price);
+                manager.AddCar("Opel Astra", 2020, price);
+                clock.Advance(std::chrono::milliseconds(random() % 900));
+            }
+            if (round % 3 == 0) {
+                manager.SellCar(1 + random() % initialPrices.size());
+            }
+            clock.Advance(std::chrono::seconds(random() % 20));
+
+            double low = 30000.0 + random() % 25000;
+            if (manager.FindAvailableByPrice(low, low + 5000.0) != expected(low, low + 5000.0)) {
+                mismatches++;
+            }
+        }
+        CHECK(mismatches == 0);
+
+        // Exact bounds of a capped car are included.
+        clock.Advance(std::chrono::hours(1));
+        double capped = Car::CalculatePrice(initialPrices[1], addTimes[1], clock.Now());
+        std::vector<unsigned int> ids = manager.FindAvailableByPrice(capped, capped);
+        CHECK(ids == expected(capped, capped));
+        CHECK(manager.FindAvailableByPrice(50000.0, 40000.0).empty());
+
+        // A new schedule and going back in time are picked up too.
+        LinearDepreciation halfOff;
+        halfOff.maxDiscount = 0.5;
+        halfOff.stepDiscount = 0.01;
+        manager.SetDepreciationSchedule(halfOff);
+        CHECK(manager.FindAvailableByPrice(60000.0, 100000.0).empty());
+        clock.Set(addTimes[0]);
+        CHECK(manager.FindAvailableByPrice(0.0, 1e9).size() == manager.GetAvailableCount());
+    }
+
+    TEST_CASE("TopKCheapestAvailable and TopKMostExpensive pick the ends of the price list") {
+        ManualClock clock;
+        CarManager manager(clock);
+        std::mt19937 random(11);
+        for (int i = 0; i < 500; i++) {
+            manager.AddCar("Opel Astra", 2020, 10000.0 + random() % 2000);
+            clock.Advance(std::chrono::seconds(random() % 5));
+        }
+        for (unsigned int id = 1; id <= 500; id += 7) {
+            manager.SellCar(id);
+        }
+        auto now = clock.Now();
+
+        // The full sorted price list of the available cars, ties in ID order.
+        std::vector<PricedCar> all = manager.TopKCheapestAvailable(1000, now);
+        REQUIRE(all.size() == manager.GetAvailableCount());
+        for (std::size_t i = 1; i < all.size(); i++) {
+            bool ordered = all[i - 1].price < all[i].price || (all[i - 1].price == all[i].price && all[i - 1].id < all[i].id);
+            CHECK(ordered);
+            CHECK_FALSE(manager.IsCarSold(all[i].id));
+        }
+
+        std::vector<PricedCar> cheapest = manager.TopKCheapestAvailable(5, now);
+        REQUIRE(cheapest.size() == 5);
+        for (std::size_t i = 0; i < 5; i++) {
+            CHECK(cheapest[i].id == all[i].id);
+            CHECK(cheapest[i].price == all[i].price);
+        }
+
+        std::vector<PricedCar> expensive = manager.TopKMostExpensive(3, now);
+        REQUIRE(expensive.size() == 3);
+        CHECK(expensive[0].price == all.back().price);
+        CHECK(expensive[2].price >= all[all.size() - 3].price);
+        CHECK(manager.TopKMostExpensive(0, now).empty());
+
+        // An hour later every car is at the 20% cap.
+        std::vector<PricedCar> later = manager.TopKCheapestAvailable(1, now + std::chrono::hours(1));
+        REQUIRE(later.size() == 1);
+        CHECK(later[0].price <= all[0].price);
+        CHECK(later[0].price >= 0.8 * 10000.0);
+    }
 
-} 
\ No newline at end of file
+}
@@ -0,0 +1,67 @@
+// test/car_store_test.cpp
+
+#include "doctest.h"
+#include "CarStore.hpp"
+#include "car.hpp"
+#include <chrono>
+#include <vector>
+
+TEST_SUITE("CarStore Tests") {
+
+    TEST_CASE("CarStore keeps car columns together") {
+        CarStore store;
+        auto addTime = std::chrono::system_clock::now();
+
+        store.Append(10, "Opel Astra", 2018, 45000.0, addTime);
+        std::size_t slot = store.Append(11, "Ford Focus", 2019, 51000.0, addTime);
+        store.MarkSold(slot, 50000.0);
+
+        REQUIRE(store.Size() == 2);
+        CHECK(store[0].GetId() == 10);
+        CHECK(store[0].GetModel() == "Opel Astra");
+        CHECK(store[0].IsSold() == false);
+        CHECK(store[1].GetModel() == "Ford Focus");
+        CHECK(store[1].GetRegisterYear() == 2019);
+        CHECK(store[1].IsSold() == true);
+        CHECK(store[1].GetSalePrice() == doctest::Approx(50000.0));
+        CHECK(store[1].GetAddTime() == addTime);
+
+        Car reference(11, "Ford Focus", 2019, 51000.0);
+        auto later = addTime + std::chrono::seconds(100);
+        CHECK(store[1].CalculateCurrentPrice(later) ==
+              doctest::Approx(reference.CalculateCurrentPrice(reference.GetAddTime() + std::chrono::seconds(100))));
+
+        store.Clear();
+        CHECK(store.Empty());
+    }
+
+    TEST_CASE("CarStore sold bitmap walks sold and available cars") {
+        CarStore store;
+        auto addTime = std::chrono::system_clock::now();
+
+        // 130 cars span three bitmap words, the last one only partly used.
+        for (unsigned int id = 1; id <= 130; id++) {
+            std::size_t slot = store.Append(id, "Bulk", 2020, 1000.0, addTime);
+            if (slot % 5 == 0 || slot == 63 || slot == 64 || slot == 129) {
+                store.MarkSold(slot, 900.0);
+            }
+        }
+        store.MarkSold(0, 850.0); // selling again does not count twice
+
+        std::vector<std::size_t> sold;
+        std::vector<std::size_t> available;
+        store.ForEachSold([&](std::size_t slot) { sold.push_back(slot); });
+        store.ForEachAvailable([&](std::size_t slot) { available.push_back(slot); });
+
+        CHECK(sold.size() == 29);
+        CHECK(store.SoldCount() == 29);
+        CHECK(store.AvailableCount() == 101);
+        CHECK(available.size() == 101);
+        CHECK(sold.front() == 0);
+        CHECK(sold.back() == 129);
+        CHECK(available.back() == 128);
+        for (std::size_t slot : available) {
+            CHECK_FALSE(store.IsSold(slot));
+        }
+    }
+}
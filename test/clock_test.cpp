@@ -0,0 +1,18 @@
+// test/clock_test.cpp
+
+#include "doctest.h"
+#include "Clock.hpp"
+#include <chrono>
+#include <thread>
+
+TEST_SUITE("Clock Tests") {
+
+    TEST_CASE("CoarseClock follows the system time in steps") {
+        CoarseClock clock(std::chrono::milliseconds(1));
+        auto first = clock.Now();
+        CHECK(std::chrono::abs(first - std::chrono::system_clock::now()) < std::chrono::seconds(1));
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        CHECK(clock.Now() > first);
+    }
+}
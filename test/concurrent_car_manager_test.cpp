@@ -0,0 +1,172 @@
+// test/concurrent_car_manager_test.cpp
+
+#include "doctest.h"
+#include "ConcurrentCarManager.hpp"
+#include <atomic>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+TEST_SUITE("ConcurrentCarManager Tests") {
+
+    TEST_CASE("ConcurrentCarManager adds and sells cars") {
+        ConcurrentCarManager manager(4);
+        CHECK(manager.GetShardCount() == 4);
+
+        unsigned int first = manager.AddCar("Opel Astra", 2018, 45000.0);
+        unsigned int second = manager.AddCar("Ford Focus", 2019, 51000.0);
+        CHECK(first == 1);
+        CHECK(second == 2);
+        CHECK(manager.GetCarCount() == 2);
+        CHECK(manager.GetNextCarId() == 3);
+
+        double price = 0.0;
+        CHECK(manager.SellCar(second, &price) == true);
+        CHECK(price == doctest::Approx(51000.0));
+        CHECK(manager.SellCar(second) == false);
+        CHECK(manager.SellCar(99) == false);
+
+        CHECK(manager.IsCarSold(first) == false);
+        CHECK(manager.IsCarSold(second) == true);
+        CHECK(manager.GetSalePrice(second, price) == true);
+        CHECK(manager.GetSalePrice(first, price) == false);
+        CHECK(manager.GetSoldCount() == 1);
+    }
+
+    TEST_CASE("ConcurrentCarManager shard count is rounded up to a power of two") {
+        CHECK(ConcurrentCarManager(5).GetShardCount() == 8);
+        CHECK(ConcurrentCarManager(1).GetShardCount() == 1);
+        CHECK(ConcurrentCarManager().GetShardCount() >= 1);
+    }
+
+    TEST_CASE("Every car is sold exactly once when terminals race") {
+        ConcurrentCarManager manager(8);
+        const unsigned int carCount = 2000;
+        const int threadCount = 4;
+
+        // Half of the cars exist up front, the other half is added during the race.
+        for (unsigned int i = 0; i < carCount / 2; i++) {
+            manager.AddCar("Race", 2020, 1000.0);
+        }
+
+        std::atomic<unsigned int> wins{0};
+        std::vector<std::thread> threads;
+        threads.emplace_back([&] {
+            for (unsigned int i = carCount / 2; i < carCount; i++) {
+                manager.AddCar("Race", 2020, 1000.0);
+            }
+        });
+        for (int t = 0; t < threadCount; t++) {
+            threads.emplace_back([&] {
+                // Every terminal tries every car, until all are gone.
+                while (manager.GetSoldCount() < carCount) {
+                    for (unsigned int id = 1; id <= carCount; id++) {
+                        if (manager.SellCar(id)) {
+                            wins++;
+                        }
+                    }
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        CHECK(wins.load() == carCount);
+        CHECK(manager.GetSoldCount() == carCount);
+        CHECK(manager.GetCarCount() == carCount);
+        CHECK(manager.GetNextCarId() == carCount + 1);
+    }
+
+    TEST_CASE("InventoryView keeps showing the inventory as it was") {
+        ConcurrentCarManager manager(2);
+        manager.AddCar("Opel Astra", 2018, 45000.0);
+        manager.AddCar("Ford Focus", 2019, 51000.0);
+
+        InventoryView before = manager.GetView();
+        manager.SellCar(1);
+        manager.AddCar("Kia Ceed", 2021, 70000.0);
+        InventoryView after = manager.GetView();
+
+        auto cars = before.GetCars();
+        REQUIRE(cars.size() == 2);
+        CHECK(cars[0].id == 1);
+        CHECK(cars[0].isSold == false);
+        CHECK(cars[1].model == "Ford Focus");
+
+        cars = after.GetCars();
+        REQUIRE(cars.size() == 3);
+        CHECK(cars[0].isSold == true);
+        CHECK(cars[0].salePrice == doctest::Approx(45000.0));
+        CHECK(cars[2].id == 3);
+        CHECK(after.GetVersion() > before.GetVersion());
+
+        std::ostringstream report;
+        after.ShowDailyReport(report);
+        CHECK(report.str().find("ID: 1\nModel: Opel Astra\nRegister Year: 2018\nSell Price: 45000\nStatus: Sold\n") != std::string::npos);
+        CHECK(report.str().find("Summary: Sold - 1, Available - 2\n") != std::string::npos);
+
+        std::ostringstream available;
+        before.ShowAvailableCars(available, std::chrono::system_clock::now());
+        CHECK(available.str().find("ID: 1\n") != std::string::npos);
+        CHECK(available.str().find("Kia Ceed") == std::string::npos);
+    }
+
+    TEST_CASE("Views taken during sales are never torn") {
+        ConcurrentCarManager manager(8);
+        const unsigned int carCount = 3000;
+        for (unsigned int i = 0; i < carCount; i++) {
+            manager.AddCar("Race", 2020, 1000.0);
+        }
+
+        // Each seller sells its cars in ID order, so every view must show
+        // a prefix of each seller's cars as sold, with no gaps.
+        const unsigned int sellerCount = 3;
+        std::vector<std::thread> sellers;
+        for (unsigned int t = 0; t < sellerCount; t++) {
+            sellers.emplace_back([&, t] {
+                for (unsigned int id = 1 + t; id <= carCount; id += sellerCount) {
+                    manager.SellCar(id);
+                }
+            });
+        }
+
+        bool torn = false;
+        std::size_t lastSold = 0;
+        bool shrinking = false;
+        while (manager.GetSoldCount() < carCount && !torn) {
+            auto cars = manager.GetView().GetCars();
+            std::size_t sold = 0;
+            std::vector<bool> gap(sellerCount, false);
+            for (const auto &car : cars) {
+                unsigned int seller = (car.id - 1) % sellerCount;
+                if (car.isSold) {
+                    sold++;
+                    torn = torn || gap[seller];
+                } else {
+                    gap[seller] = true;
+                }
+            }
+            shrinking = shrinking || sold < lastSold;
+            lastSold = sold;
+        }
+        for (auto &seller : sellers) {
+            seller.join();
+        }
+
+        CHECK_FALSE(torn);
+        CHECK_FALSE(shrinking);
+        CHECK(manager.GetView().GetCars().size() == carCount);
+    }
+
+    TEST_CASE("ConcurrentCarManager prices sales with its clock") {
+        ManualClock clock;
+        ConcurrentCarManager manager(4, kDefaultDepreciation, clock);
+        unsigned int id = manager.AddCar("Opel Astra", 2020, 100000.0);
+
+        clock.Advance(std::chrono::hours(1));
+        double price = 0.0;
+        CHECK(manager.SellCar(id, &price));
+        CHECK(price == doctest::Approx(80000.0));
+    }
+}
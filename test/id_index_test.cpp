@@ -0,0 +1,67 @@
+// test/id_index_test.cpp
+
+#include "doctest.h"
+#include "IdIndex.hpp"
+#include "CarManager.hpp"
+#include <cstdio>
+#include <fstream>
+
+TEST_SUITE("IdIndex Tests") {
+
+    TEST_CASE("IdIndex finds slots across growth and keeps the first of duplicate IDs") {
+        IdIndex index;
+        for (unsigned int id = 1; id <= 5000; id++) {
+            CHECK(index.Insert(id * 7, id - 1));
+        }
+        CHECK(index.Size() == 5000);
+        CHECK(index.Find(7) == 0);
+        CHECK(index.Find(5000 * 7) == 4999);
+        CHECK(index.Find(8) == IdIndex::npos);
+
+        CHECK_FALSE(index.Insert(7, 123));
+        CHECK(index.Find(7) == 0);
+
+        index.Clear();
+        CHECK(index.Size() == 0);
+        CHECK(index.Find(7) == IdIndex::npos);
+    }
+
+    TEST_CASE("ID lookups work for IDs loaded from file") {
+        const char* path = "id_index_test.csv";
+        {
+            std::ofstream out(path);
+            out << "7;Opel Astra;2018;45000.00;0;0.00\n";
+            out << "3;Ford Focus;2019;51000.00;1;50000.00\n";
+            out << "42;Honda Civic;2022;85000.00;0;0.00\n";
+        }
+
+        CarManager manager;
+        manager.LoadFromFile(path);
+        std::remove(path);
+
+        CHECK(manager.GetCarCount() == 3);
+        CHECK(manager.GetNextCarId() == 43);
+        CHECK(manager.IsCarSold(3) == true);
+        CHECK(manager.IsCarSold(7) == false);
+        CHECK(manager.SellCar(1) == false);
+
+        CHECK(manager.SellCar(42) == true);
+        CHECK(manager.IsCarSold(42) == true);
+
+        manager.AddCar("NewOne", 2024, 1000.0);
+        CHECK(manager.IsCarSold(43) == false);
+        CHECK(manager.SellCar(43) == true);
+    }
+
+    TEST_CASE("ID lookups keep working with many cars") {
+        CarManager manager;
+        for (int i = 0; i < 1000; i++) {
+            manager.AddCar("Bulk", 2020, 1000.0 + i);
+        }
+
+        CHECK(manager.SellCar(500) == true);
+        CHECK(manager.IsCarSold(500) == true);
+        CHECK(manager.IsCarSold(499) == false);
+        CHECK(manager.IsCarSold(1001) == false);
+    }
+}
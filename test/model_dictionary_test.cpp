@@ -0,0 +1,34 @@
+// test/model_dictionary_test.cpp
+
+#include "doctest.h"
+#include "ModelDictionary.hpp"
+#include "CarStore.hpp"
+#include <chrono>
+
+TEST_SUITE("ModelDictionary Tests") {
+
+    TEST_CASE("ModelDictionary gives every model name one ID") {
+        ModelDictionary dictionary;
+        CHECK(dictionary.Intern("Opel Astra") == 0);
+        CHECK(dictionary.Intern("Ford Focus") == 1);
+        CHECK(dictionary.Intern("Opel Astra") == 0);
+        CHECK(dictionary.Find("Ford Focus") == 1);
+        CHECK(dictionary.Find("Opel") == ModelDictionary::npos);
+        CHECK(dictionary.Name(1) == "Ford Focus");
+        CHECK(dictionary.Size() == 2);
+
+        CarStore store;
+        auto addTime = std::chrono::system_clock::now();
+        store.Append(1, "Opel Astra", 2018, 45000.0, addTime);
+        store.Append(2, "Ford Focus", 2019, 51000.0, addTime);
+        store.Append(3, "Opel Astra", 2020, 55000.0, addTime);
+        CHECK(store.GetModelId(0) == store.GetModelId(2));
+        CHECK(store.GetModelId(0) != store.GetModelId(1));
+        CHECK(store.GetModel(2) == "Opel Astra");
+        CHECK(store.Models().Size() == 2);
+
+        dictionary.Clear();
+        CHECK(dictionary.Size() == 0);
+        CHECK(dictionary.Intern("Ford Focus") == 0);
+    }
+}
@@ -0,0 +1,35 @@
+// test/model_index_test.cpp
+
+#include "doctest.h"
+#include "ModelIndex.hpp"
+#include "ModelDictionary.hpp"
+#include <cstdint>
+#include <vector>
+
+TEST_SUITE("ModelIndex Tests") {
+
+    TEST_CASE("ModelIndex keeps posting lists right when cars are sold") {
+        ModelDictionary models;
+        ModelIndex index;
+        for (std::size_t slot = 0; slot < 100; slot++) {
+            std::uint32_t modelId = models.Intern(slot % 2 ? "Audi A4" : "Audi A6");
+            index.Add(slot, modelId, models.Name(modelId), false);
+        }
+        CHECK(index.GetModelCount() == 2);
+
+        for (std::size_t slot = 0; slot < 100; slot += 3) {
+            index.MarkSold(slot);
+            index.MarkSold(slot); // selling twice changes nothing
+        }
+
+        std::vector<std::size_t> expected;
+        for (std::size_t slot = 0; slot < 100; slot++) {
+            if (slot % 3 != 0 && slot % 2 == 1) {
+                expected.push_back(slot);
+            }
+        }
+        CHECK(index.FindAvailable("Audi A4") == expected);
+        CHECK(index.FindAvailable("Audi").size() == 66);
+        CHECK(index.FindAvailable("Audi A8").empty());
+    }
+}
@@ -0,0 +1,74 @@
+// test/price_range_index_test.cpp
+
+#include "doctest.h"
+#include "PriceRangeIndex.hpp"
+#include "CarStore.hpp"
+#include "Depreciation.hpp"
+#include <chrono>
+#include <vector>
+
+TEST_SUITE("PriceRangeIndex Tests") {
+
+    TEST_CASE("PriceRangeIndex folds capped cars into a few sorted runs") {
+        CarStore store;
+        DepreciationPricer pricer;
+        PriceRangeIndex index;
+        auto start = std::chrono::system_clock::now();
+        index.Find(store, pricer, 0.0, 1.0, start);
+
+        // One car per second for three hours; only the last 2030 seconds are still stepping.
+        for (int second = 0; second < 3 * 3600; second++) {
+            auto now = start + std::chrono::seconds(second);
+            std::size_t slot = store.Append(second + 1, "Kia Ceed", 2021, 10000.0 + second, now);
+            index.Add(slot, 10000.0 + second, now);
+            if (second % 60 == 0) {
+                index.Find(store, pricer, 0.0, 1.0, now);
+            }
+        }
+
+        auto end = start + std::chrono::seconds(3 * 3600);
+        std::vector<std::size_t> all = index.Find(store, pricer, 0.0, 1e9, end);
+        CHECK(all.size() == store.Size());
+        CHECK(index.GetSteppingGroupCount() <= 2031);
+        CHECK(index.GetCappedRunCount() <= 16);
+
+        // Capped cars sit at 80% of 10000 + second.
+        std::vector<std::size_t> cheap = index.Find(store, pricer, 8000.0, 8000.0 + 0.8 * 99.5, end);
+        REQUIRE(cheap.size() == 100);
+        CHECK(cheap.front() == 0);
+        CHECK(cheap.back() == 99);
+    }
+
+    TEST_CASE("PriceRangeIndex drops sold cars once most of them are sold") {
+        CarStore store;
+        DepreciationPricer pricer;
+        PriceRangeIndex index;
+        auto start = std::chrono::system_clock::now();
+        index.Find(store, pricer, 0.0, 1.0, start);
+
+        // Two cars per second; by the end the first half are capped and the rest still stepping.
+        for (int i = 0; i < 4000; i++) {
+            auto addTime = start + std::chrono::seconds(i / 2);
+            std::size_t slot = store.Append(i + 1, "Kia Ceed", 2021, 10000.0 + i % 997, addTime);
+            index.Add(slot, 10000.0 + i % 997, addTime);
+        }
+        auto end = start + std::chrono::seconds(3000);
+        CHECK(index.Find(store, pricer, 0.0, 1e9, end).size() == 4000);
+        CHECK(index.GetCappedRunCount() > 0);
+        CHECK(index.GetSteppingGroupCount() > 0);
+
+        // Sell nine cars in ten; at most one sold car per kept one may linger.
+        for (std::size_t slot = 0; slot < 4000; slot++) {
+            if (slot % 10 != 9) {
+                store.MarkSold(slot, 1.0);
+                index.MarkSold(store, slot);
+            }
+        }
+        CHECK(index.GetEntryCount() <= 2 * 400);
+
+        std::vector<std::size_t> left = index.Find(store, pricer, 0.0, 1e9, end);
+        REQUIRE(left.size() == 400);
+        CHECK(left.front() == 9);
+        CHECK(left.back() == 3999);
+    }
+}
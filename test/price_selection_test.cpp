@@ -0,0 +1,40 @@
+// test/price_selection_test.cpp
+
+#include "doctest.h"
+#include "PriceSelection.hpp"
+#include "CarStore.hpp"
+#include "Depreciation.hpp"
+#include <chrono>
+#include <random>
+#include <vector>
+
+TEST_SUITE("SelectByPrice Tests") {
+
+    TEST_CASE("SelectByPrice gives the same cars on one thread and on many") {
+        CarStore store;
+        DepreciationPricer pricer;
+        auto start = std::chrono::system_clock::now();
+        std::mt19937 random(3);
+        for (int i = 0; i < 10007; i++) {
+            store.Append(i + 1, "Kia Ceed", 2021, 5000.0 + random() % 1000, start - std::chrono::seconds(random() % 3000));
+            if (random() % 4 == 0) {
+                store.MarkSold(i, 1.0);
+            }
+        }
+
+        for (PriceOrder order : {PriceOrder::Cheapest, PriceOrder::MostExpensive}) {
+            std::vector<PricedSlot> serial = SelectByPrice(store, pricer, 100, start, order, 1);
+            std::vector<PricedSlot> parallel = SelectByPrice(store, pricer, 100, start, order, 4, 100);
+            REQUIRE(serial.size() == 100);
+            REQUIRE(parallel.size() == 100);
+
+            int mismatches = 0;
+            for (std::size_t i = 0; i < serial.size(); i++) {
+                if (serial[i].slot != parallel[i].slot || serial[i].price != parallel[i].price || store.IsSold(serial[i].slot)) {
+                    mismatches++;
+                }
+            }
+            CHECK(mismatches == 0);
+        }
+    }
+}
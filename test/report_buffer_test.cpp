@@ -0,0 +1,45 @@
+// test/report_buffer_test.cpp
+
+#include "doctest.h"
+#include "ReportBuffer.hpp"
+#include <iomanip>
+#include <ios>
+#include <sstream>
+#include <string>
+
+TEST_SUITE("ReportBuffer Tests") {
+
+    TEST_CASE("ReportBuffer formats numbers like the target stream") {
+        const double values[] = {45000.0, 12345.678, 0.1, 1e21, -3.5};
+
+        auto check = [&](std::ostringstream &expected) {
+            ReportBuffer report;
+            report.UseFloatFormatOf(expected);
+            for (double value : values) {
+                report.Append(value).Append(";");
+                expected << value << ";";
+            }
+            CHECK(std::string(report.View()) == expected.str());
+        };
+
+        std::ostringstream plain;
+        check(plain);
+
+        std::ostringstream fixed;
+        fixed << std::fixed << std::setprecision(2);
+        check(fixed);
+
+        // Flags to_chars does not cover still come out as the stream would print them.
+        std::ostringstream showpoint;
+        showpoint << std::showpoint;
+        check(showpoint);
+
+        std::ostringstream upper;
+        upper << std::scientific << std::uppercase << std::showpos;
+        check(upper);
+
+        std::ostringstream hex;
+        hex << std::hexfloat;
+        check(hex);
+    }
+}
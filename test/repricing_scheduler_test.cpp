@@ -0,0 +1,61 @@
+// test/repricing_scheduler_test.cpp
+
+#include "doctest.h"
+#include "RepricingScheduler.hpp"
+#include "CarStore.hpp"
+#include "Depreciation.hpp"
+#include <chrono>
+
+TEST_SUITE("RepricingScheduler Tests") {
+
+    TEST_CASE("RepricingScheduler only reprices cars whose step is due") {
+        CarStore store;
+        DepreciationPricer pricer;
+        RepricingScheduler repricing;
+        auto start = std::chrono::system_clock::now();
+
+        for (int i = 0; i < 100; i++) {
+            store.Append(i + 1, "Opel Astra", 2020, 1000.0 + i, start + std::chrono::milliseconds(i * 137));
+        }
+
+        // The first read prices everything, the next one at the same time nothing.
+        CHECK(repricing.AdvanceTo(store, pricer, start) == 100);
+        CHECK(repricing.AdvanceTo(store, pricer, start) == 0);
+        CHECK(repricing.PendingCount() == 100);
+
+        int mismatches = 0;
+        std::size_t repriced = 0;
+        for (int second = 1; second <= 2200; second++) {
+            auto now = start + std::chrono::seconds(second);
+
+            if (second == 500) {
+                store.MarkSold(3, 900.0);
+            }
+            if (second == 700) {
+                std::size_t slot = store.Append(101, "Kia Ceed", 2021, 5000.0, now);
+                repricing.Add(slot, 5000.0, now, pricer);
+            }
+
+            repriced += repricing.AdvanceTo(store, pricer, now);
+            store.ForEachAvailable([&](std::size_t slot) {
+                if (repricing.Price(slot) != pricer.Price(store.GetInitialPrice(slot), store.GetAddTime(slot), now)) {
+                    mismatches++;
+                }
+            });
+        }
+        CHECK(mismatches == 0);
+
+        // About 200 steps per car instead of one price per car and read.
+        CHECK(repriced < 101 * 205);
+        // Only the late Kia is still stepping; once it hits the cap nothing is left to do.
+        CHECK(repricing.PendingCount() == 1);
+        CHECK(repricing.AdvanceTo(store, pricer, start + std::chrono::hours(1)) == 1);
+        CHECK(repricing.PendingCount() == 0);
+        CHECK(repricing.AdvanceTo(store, pricer, start + std::chrono::hours(2)) == 0);
+
+        // Going back in time starts over from scratch.
+        repricing.AdvanceTo(store, pricer, start + std::chrono::seconds(45));
+        CHECK(repricing.Price(0) == doctest::Approx(1000.0 * 0.998));
+        CHECK(repricing.PendingCount() == 100);
+    }
+}
@@ -0,0 +1,33 @@
+// test/string_arena_test.cpp
+
+#include "doctest.h"
+#include "StringArena.hpp"
+#include <string>
+#include <string_view>
+
+TEST_SUITE("StringArena Tests") {
+
+    TEST_CASE("StringArena keeps stored strings in place") {
+        StringArena arena(16);
+        std::string_view a = arena.Store("Opel Astra");
+        std::string_view b = arena.Store("Skoda Octavia"); // does not fit, new block
+        std::string_view c = arena.Store("a model name longer than one block");
+
+        CHECK(arena.BlockCount() == 3);
+        CHECK(a == "Opel Astra");
+        CHECK(b == "Skoda Octavia");
+        CHECK(c == "a model name longer than one block");
+        CHECK(arena.Size() == a.size() + b.size() + c.size());
+
+        arena.Reserve(100);
+        std::size_t blocks = arena.BlockCount();
+        arena.Store(std::string(60, 'x'));
+        arena.Store(std::string(40, 'y'));
+        CHECK(arena.BlockCount() == blocks);
+
+        arena.Clear();
+        CHECK(arena.BlockCount() == 0);
+        CHECK(arena.Size() == 0);
+        CHECK(arena.Capacity() == 0);
+    }
+}
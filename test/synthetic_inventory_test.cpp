@@ -0,0 +1,120 @@
+// test/synthetic_inventory_test.cpp
+
+#include "doctest.h"
+#include "SyntheticInventory.hpp"
+#include "CarManager.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::string ReadFile(const char *path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::ostringstream text;
+        text << in.rdbuf();
+        return text.str();
+    }
+}
+
+TEST_SUITE("SyntheticInventory Tests") {
+
+    TEST_CASE("Generated files depend on the seed, not on the thread count") {
+        InventoryOptions options;
+        options.rows = 2 * SyntheticInventory::kBlockRows + 123; // last block is partial
+        options.threads = 1;
+        const char* one = "synthetic_one_thread.csv";
+        const char* many = "synthetic_many_threads.csv";
+        const char* other = "synthetic_other_seed.csv";
+
+        REQUIRE(SyntheticInventory(options).WriteCsv(one));
+        options.threads = 3;
+        REQUIRE(SyntheticInventory(options).WriteCsv(many));
+        options.seed = 2;
+        REQUIRE(SyntheticInventory(options).WriteCsv(other));
+
+        std::string first = ReadFile(one);
+        CHECK(first == ReadFile(many));
+        CHECK(first != ReadFile(other));
+        CHECK(first.rfind("131195;", std::string::npos) != std::string::npos);
+
+        std::remove(one);
+        std::remove(many);
+        std::remove(other);
+    }
+
+    TEST_CASE("Generated cars follow the requested distributions") {
+        InventoryOptions options;
+        options.rows = 100000;
+        options.modelCount = 100;
+        options.minYear = 2010;
+        options.maxYear = 2012;
+        options.soldRatio = 0.25;
+        options.threads = 2;
+        SyntheticInventory inventory(options);
+
+        const char* path = "synthetic_distribution.csv";
+        REQUIRE(inventory.WriteCsv(path));
+        CarManager manager;
+        manager.LoadFromFile(path);
+        std::remove(path);
+
+        REQUIRE(manager.GetCarCount() == 100000);
+        CHECK(manager.GetNextCarId() == 100001);
+        CHECK(manager.GetSoldCount() > 24000);
+        CHECK(manager.GetSoldCount() < 26000);
+
+        // Zipf: the top model is far more common than the tenth, and that one than the last.
+        std::vector<std::uint32_t> modelIds(SyntheticInventory::kBlockRows);
+        std::size_t counts[100] = {};
+        for (std::uint64_t block = 0; block < inventory.BlockCount(); block++) {
+            inventory.ModelIds(block, modelIds.data());
+            for (std::size_t row = 0; row < inventory.BlockRows(block); row++) {
+                counts[modelIds[row]]++;
+            }
+        }
+        CHECK(counts[0] > 5 * counts[9]);
+        CHECK(counts[9] > 5 * counts[99]);
+
+        std::vector<std::uint32_t> years(SyntheticInventory::kBlockRows);
+        inventory.RegisterYears(0, years.data());
+        for (std::size_t row = 0; row < inventory.BlockRows(0); row++) {
+            CHECK_UNARY(years[row] >= 2010 && years[row] <= 2012);
+        }
+    }
+
+    TEST_CASE("Generated snapshots hold the same cars as generated CSV files") {
+        InventoryOptions options;
+        options.rows = SyntheticInventory::kBlockRows + 77;
+        options.modelCount = 500;
+        SyntheticInventory inventory(options);
+
+        const char* csv = "synthetic_same.csv";
+        const char* snapshot = "synthetic_same.snap";
+        REQUIRE(inventory.WriteCsv(csv));
+        REQUIRE(inventory.WriteSnapshot(snapshot));
+
+        CarManager fromCsv;
+        CarManager fromSnapshot;
+        fromCsv.LoadFromFile(csv);
+        REQUIRE(fromSnapshot.LoadSnapshot(snapshot));
+        std::remove(csv);
+        std::remove(snapshot);
+
+        CHECK(fromSnapshot.GetCarCount() == fromCsv.GetCarCount());
+        CHECK(fromSnapshot.GetNextCarId() == fromCsv.GetNextCarId());
+
+        std::ostringstream csvReport, snapshotReport;
+        fromCsv.ShowDailyReport(csvReport);
+        fromSnapshot.ShowDailyReport(snapshotReport);
+        CHECK(csvReport.str() == snapshotReport.str());
+
+        InventoryStatistics csvStatistics = fromCsv.GetStatistics();
+        InventoryStatistics snapshotStatistics = fromSnapshot.GetStatistics();
+        CHECK(csvStatistics.totalRevenue == doctest::Approx(snapshotStatistics.totalRevenue));
+        CHECK(fromCsv.FindAvailableByModel("Skoda") == fromSnapshot.FindAvailableByModel("Skoda"));
+    }
+}
@@ -1,8 +1,10 @@
 #include "doctest.h"
 #include "car.hpp"
+#include "Depreciation.hpp"
 
 #include <chrono>
 #include <cmath>
+#include <vector>
 
 using namespace std::chrono;
 
@@ -69,4 +71,148 @@ TEST_SUITE("Car Tests")
                       "Price should stay the same if currentTime is before addTime");
     }
     
+    TEST_CASE("CalculatePrices matches CalculateCurrentPrice") {
+        Car c(6, "BatchCar", 2020, 12345.67);
+        auto addTime = c.GetAddTime();
+
+        std::vector<system_clock::rep> addTimes;
+        std::vector<double> initialPrices;
+        std::vector<double> expected;
+
+        // Every second around the thresholds, sub-second offsets, the past and the cap.
+        auto now = addTime + seconds(2500);
+        for (int s = -20; s <= 2500; s++) {
+            for (nanoseconds offset : {nanoseconds(0), nanoseconds(1), nanoseconds(milliseconds(999))}) {
+                auto sampleAdd = now - seconds(s) - duration_cast<system_clock::duration>(offset);
+                addTimes.push_back(sampleAdd.time_since_epoch().count());
+                initialPrices.push_back(1000.0 + s);
+                expected.push_back(Car::CalculatePrice(1000.0 + s, sampleAdd, now));
+            }
+        }
+
+        std::vector<double> actual(addTimes.size());
+        Car::CalculatePrices(addTimes.data(), initialPrices.data(), addTimes.size(), now, actual.data());
+
+        int mismatches = 0;
+        for (std::size_t i = 0; i < actual.size(); i++) {
+            if (actual[i] != expected[i]) {
+                mismatches++;
+            }
+        }
+        CHECK(mismatches == 0);
+        CHECK(c.CalculateCurrentPrice(addTime + seconds(40)) == Car::CalculatePrice(12345.67, addTime, addTime + seconds(40)));
+    }
+
+    TEST_CASE("DepreciatedPrices matches DepreciatedPrice for every schedule") {
+        LinearDepreciation linear;
+        linear.graceSeconds = 5;
+        linear.stepSeconds = 3;
+        linear.firstDiscount = 0.05;
+        linear.stepDiscount = 0.01;
+        linear.maxDiscount = 0.5;
+
+        ExponentialDepreciation exponential;
+        exponential.stepRate = 0.01;
+
+        TabulatedDepreciation tabulated;
+        tabulated.discounts[0] = 0.02;
+        tabulated.discounts[1] = 0.07;
+        tabulated.discounts[2] = 0.15;
+        tabulated.count = 3;
+
+        LinearDepreciation daily; // still changing after a month, takes the slow path
+        daily.stepSeconds = 86400;
+        daily.stepDiscount = 0.0001;
+
+        std::vector<DepreciationSchedule> schedules = {kDefaultDepreciation, linear, exponential, tabulated, TabulatedDepreciation(), daily};
+        auto now = system_clock::now();
+
+        for (const DepreciationSchedule &schedule : schedules) {
+            std::vector<system_clock::rep> addTimes;
+            std::vector<double> initialPrices;
+            std::vector<double> expected;
+
+            for (int s = -20; s <= 4000; s += 1) {
+                auto sampleAdd = now - seconds(s * (s % 7 == 0 ? 3600 : 1)) - milliseconds(s % 3 * 400);
+                addTimes.push_back(sampleAdd.time_since_epoch().count());
+                initialPrices.push_back(500.0 + s);
+                expected.push_back(DepreciatedPrice(schedule, 500.0 + s, sampleAdd, now));
+            }
+
+            std::vector<double> actual(addTimes.size());
+            DepreciatedPrices(schedule, addTimes.data(), initialPrices.data(), addTimes.size(), now, actual.data());
+
+            int mismatches = 0;
+            for (std::size_t i = 0; i < actual.size(); i++) {
+                if (actual[i] != expected[i]) {
+                    mismatches++;
+                }
+            }
+            CHECK(mismatches == 0);
+        }
+
+        CHECK(DepreciatedPrice(exponential, 100.0, now - seconds(40), now) == doctest::Approx(100.0 * 0.99 * 0.99));
+        CHECK(DepreciatedPrice(tabulated, 100.0, now - seconds(10000), now) == doctest::Approx(85.0));
+    }
+
+    TEST_CASE("DepreciationPricer prices from its table like the schedule does") {
+        LinearDepreciation linear;
+        linear.graceSeconds = 5;
+        linear.stepSeconds = 3;
+        linear.firstDiscount = 0.05;
+        linear.stepDiscount = 0.01;
+        linear.maxDiscount = 0.5;
+
+        ExponentialDepreciation exponential;
+        exponential.stepRate = 0.01;
+
+        TabulatedDepreciation tabulated;
+        tabulated.discounts[0] = 0.02;
+        tabulated.discounts[1] = 0.07;
+        tabulated.count = 2;
+
+        LinearDepreciation daily; // saturates after 2000 steps, too long for the table
+        daily.stepSeconds = 86400;
+        daily.stepDiscount = 0.0001;
+
+        CHECK(DepreciationPricer(linear).UsesTable());
+        CHECK(DepreciationPricer(exponential).UsesTable());
+        CHECK(DepreciationPricer(tabulated).UsesTable());
+        CHECK(DepreciationPricer().UsesTable());
+        CHECK_FALSE(DepreciationPricer(daily).UsesTable());
+
+        std::vector<DepreciationSchedule> schedules = {kDefaultDepreciation, linear, exponential, tabulated, daily};
+        auto now = system_clock::now();
+
+        for (const DepreciationSchedule &schedule : schedules) {
+            DepreciationPricer pricer(schedule);
+            std::vector<system_clock::rep> addTimes;
+            std::vector<double> initialPrices;
+            std::vector<double> expected;
+
+            for (int s = -20; s <= 4000; s += 1) {
+                auto sampleAdd = now - seconds(s * (s % 7 == 0 ? 3600 : 1));
+                addTimes.push_back(sampleAdd.time_since_epoch().count());
+                initialPrices.push_back(500.0 + s);
+                expected.push_back(DepreciatedPrice(schedule, 500.0 + s, sampleAdd, now));
+            }
+
+            std::vector<double> actual(addTimes.size());
+            pricer.Prices(addTimes.data(), initialPrices.data(), addTimes.size(), now, actual.data());
+
+            int mismatches = 0;
+            for (std::size_t i = 0; i < actual.size(); i++) {
+                auto addTime = system_clock::time_point(system_clock::duration(addTimes[i]));
+                if (actual[i] != expected[i] || pricer.Price(initialPrices[i], addTime, now) != expected[i]) {
+                    mismatches++;
+                }
+            }
+            CHECK(mismatches == 0);
+        }
+
+        // The table of the default rule is built by the compiler.
+        static_assert(kDefaultMultiplierTable.MultiplierAtStep(0) == 1.0);
+        static_assert(kDefaultMultiplierTable.MultiplierAtStep(100000) == kDefaultDepreciation.MultiplierAtStep(100000));
+    }
+
 }
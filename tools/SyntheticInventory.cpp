@@ -0,0 +1,420 @@
+#include "SyntheticInventory.hpp"
+#include "Snapshot.hpp"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    // The random streams of one block; each column draws from its own.
+    enum Stream : std::uint64_t
+    {
+        ModelStream,
+        YearStream,
+        PriceStream,
+        SoldStream,
+        DiscountStream,
+        StreamCount,
+    };
+
+    std::uint64_t Mix(std::uint64_t x)
+    {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+
+    // SplitMix64: tiny state and fast to seed, so every block can have fresh streams.
+    class Random
+    {
+
+    private:
+        std::uint64_t _state;
+
+    public:
+        Random(std::uint64_t seed, std::uint64_t block, Stream stream)
+            : _state(Mix(seed ^ Mix(block * StreamCount + stream + 1))){};
+
+        std::uint64_t Next()
+        {
+            _state += 0x9e3779b97f4a7c15ull;
+            return Mix(_state);
+        }
+
+        /// Uniform in [0, 1).
+        double NextDouble() { return (Next() >> 11) * (1.0 / 9007199254740992.0); }
+
+        /// Uniform in [low, high].
+        std::uint64_t NextInRange(std::uint64_t low, std::uint64_t high) { return low + Next() % (high - low + 1); }
+    };
+
+    const char *const kBrands[] = {
+        "Skoda", "Toyota", "Ford", "Honda", "Volkswagen", "Opel", "Kia", "Hyundai",
+        "Renault", "Peugeot", "BMW", "Audi", "Mercedes-Benz", "Mazda", "Nissan", "Fiat",
+        "Seat", "Volvo", "Citroen", "Dacia", "Suzuki", "Mitsubishi", "Subaru", "Lexus",
+    };
+    const char *const kSeries[] = {
+        "Octavia", "Corolla", "Focus", "Civic", "Golf", "Astra", "Ceed", "i30",
+        "Clio", "308", "320d", "A4", "C 200", "3", "Qashqai", "Panda",
+        "Leon", "V60", "C4", "Duster", "Swift", "Outlander", "Impreza", "IS 300",
+        "Fabia", "Yaris", "Fiesta", "Jazz", "Passat", "Corsa", "Sportage", "Tucson",
+        "Megane", "208", "X3", "A6", "E 220", "CX-5", "Juke", "Tipo",
+    };
+    constexpr std::size_t kBrandCount = sizeof(kBrands) / sizeof(kBrands[0]);
+    constexpr std::size_t kSeriesCount = sizeof(kSeries) / sizeof(kSeries[0]);
+
+    // Model names that look real: a brand, a series, and a generation once those run out.
+    std::string ModelName(std::size_t rank)
+    {
+        std::string name = kBrands[rank % kBrandCount];
+        name += ' ';
+        name += kSeries[(rank / kBrandCount) % kSeriesCount];
+
+        std::size_t generation = rank / (kBrandCount * kSeriesCount);
+        if (generation > 0)
+        {
+            name += " Mk";
+            name += std::to_string(generation + 1);
+        }
+        return name;
+    }
+
+    void AppendNumber(std::string &buffer, std::uint64_t value)
+    {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        buffer.append(digits, result.ptr);
+    }
+
+    // Prints cents with exactly two decimals, the way SaveToFile prints prices.
+    void AppendCents(std::string &buffer, std::uint64_t cents)
+    {
+        AppendNumber(buffer, cents / 100);
+        buffer += '.';
+        buffer += static_cast<char>('0' + cents / 10 % 10);
+        buffer += static_cast<char>('0' + cents % 10);
+    }
+
+    // Appends the raw bytes of a column to a block buffer.
+    template <typename T>
+    void AppendColumn(std::string &buffer, const std::vector<T> &column)
+    {
+        buffer.append(reinterpret_cast<const char *>(column.data()), column.size() * sizeof(T));
+    }
+}
+
+SyntheticInventory::SyntheticInventory(const InventoryOptions &options) : _options(options)
+{
+    _options.modelCount = std::max<std::uint32_t>(_options.modelCount, 1);
+    _options.maxYear = std::max(_options.maxYear, _options.minYear);
+    _options.maxPrice = std::max(_options.maxPrice, _options.minPrice);
+    _options.soldRatio = std::clamp(_options.soldRatio, 0.0, 1.0);
+    if (_options.addTime == std::chrono::system_clock::time_point())
+    {
+        _options.addTime = std::chrono::system_clock::now();
+    }
+
+    _models.reserve(_options.modelCount);
+    _modelCdf.reserve(_options.modelCount);
+    double total = 0.0;
+    for (std::size_t rank = 0; rank < _options.modelCount; rank++)
+    {
+        _models.push_back(ModelName(rank));
+        total += 1.0 / std::pow(static_cast<double>(rank + 1), _options.zipfExponent);
+        _modelCdf.push_back(total);
+    }
+    for (double &share : _modelCdf)
+    {
+        share /= total;
+    }
+    _modelCdf.back() = 1.0;
+}
+
+unsigned int SyntheticInventory::Threads() const
+{
+    unsigned int threads = _options.threads > 0 ? _options.threads : std::thread::hardware_concurrency();
+    return threads > 0 ? threads : 1;
+}
+
+std::size_t SyntheticInventory::BlockRows(std::uint64_t block) const
+{
+    return static_cast<std::size_t>(std::min<std::uint64_t>(kBlockRows, _options.rows - block * kBlockRows));
+}
+
+void SyntheticInventory::ModelIds(std::uint64_t block, std::uint32_t *modelIds) const
+{
+    Random random(_options.seed, block, ModelStream);
+    for (std::size_t row = 0, count = BlockRows(block); row < count; row++)
+    {
+        auto rank = std::upper_bound(_modelCdf.begin(), _modelCdf.end(), random.NextDouble()) - _modelCdf.begin();
+        modelIds[row] = static_cast<std::uint32_t>(std::min<std::size_t>(rank, _modelCdf.size() - 1));
+    }
+}
+
+void SyntheticInventory::RegisterYears(std::uint64_t block, std::uint32_t *years) const
+{
+    Random random(_options.seed, block, YearStream);
+    for (std::size_t row = 0, count = BlockRows(block); row < count; row++)
+    {
+        years[row] = static_cast<std::uint32_t>(random.NextInRange(_options.minYear, _options.maxYear));
+    }
+}
+
+void SyntheticInventory::InitialPrices(std::uint64_t block, std::uint64_t *cents) const
+{
+    Random random(_options.seed, block, PriceStream);
+    for (std::size_t row = 0, count = BlockRows(block); row < count; row++)
+    {
+        cents[row] = random.NextInRange(_options.minPrice, _options.maxPrice) * 100;
+    }
+}
+
+void SyntheticInventory::SoldFlags(std::uint64_t block, std::uint8_t *soldFlags) const
+{
+    Random random(_options.seed, block, SoldStream);
+    for (std::size_t row = 0, count = BlockRows(block); row < count; row++)
+    {
+        soldFlags[row] = random.NextDouble() < _options.soldRatio;
+    }
+}
+
+void SyntheticInventory::SalePrices(std::uint64_t block, const std::uint64_t *initialCents, const std::uint8_t *soldFlags,
+                                    std::uint64_t *cents) const
+{
+    // Sold cars went for up to 5% below their initial price.
+    Random random(_options.seed, block, DiscountStream);
+    for (std::size_t row = 0, count = BlockRows(block); row < count; row++)
+    {
+        double discount = random.NextDouble() * 0.05;
+        cents[row] = soldFlags[row] ? static_cast<std::uint64_t>(std::llround(initialCents[row] * (1.0 - discount))) : 0;
+    }
+}
+
+template <typename Fill, typename Write>
+void SyntheticInventory::ForEachBlock(Fill fill, Write write) const
+{
+    const std::uint64_t blockCount = BlockCount();
+    const unsigned int threads = Threads();
+
+    // Block b is made in ring slot b % ring.size(); a worker only starts on
+    // it once the writer is done with the block that used the slot before.
+    struct Slot
+    {
+        std::string buffer;
+        bool ready = false;
+    };
+    std::vector<Slot> ring(2 * static_cast<std::size_t>(threads));
+    std::atomic<std::uint64_t> nextBlock{0};
+    std::uint64_t written = 0;
+    std::mutex mutex;
+    std::condition_variable filled;
+    std::condition_variable drained;
+
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&]
+                             {
+                                 for (std::uint64_t block; (block = nextBlock.fetch_add(1)) < blockCount;)
+                                 {
+                                     Slot &slot = ring[block % ring.size()];
+                                     {
+                                         std::unique_lock<std::mutex> lock(mutex);
+                                         drained.wait(lock, [&]
+                                                      { return block < written + ring.size(); });
+                                     }
+
+                                     slot.buffer.clear();
+                                     fill(block, slot.buffer);
+
+                                     std::lock_guard<std::mutex> lock(mutex);
+                                     slot.ready = true;
+                                     filled.notify_all();
+                                 } });
+    }
+
+    // Blocks are written in order on this thread while the workers fill the ones behind them.
+    for (std::uint64_t block = 0; block < blockCount; block++)
+    {
+        Slot &slot = ring[block % ring.size()];
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            filled.wait(lock, [&]
+                        { return slot.ready; });
+        }
+
+        write(slot.buffer);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        slot.ready = false;
+        written++;
+        drained.notify_all();
+    }
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+bool SyntheticInventory::WriteCsv(const std::string &filename) const
+{
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+    {
+        return false;
+    }
+
+    ForEachBlock(
+        [&](std::uint64_t block, std::string &buffer)
+        {
+            const std::size_t count = BlockRows(block);
+            std::vector<std::uint32_t> modelIds(count);
+            std::vector<std::uint32_t> years(count);
+            std::vector<std::uint64_t> prices(count);
+            std::vector<std::uint64_t> salePrices(count);
+            std::vector<std::uint8_t> sold(count);
+            ModelIds(block, modelIds.data());
+            RegisterYears(block, years.data());
+            InitialPrices(block, prices.data());
+            SoldFlags(block, sold.data());
+            SalePrices(block, prices.data(), sold.data(), salePrices.data());
+
+            buffer.reserve(count * 48);
+            for (std::size_t row = 0; row < count; row++)
+            {
+                AppendNumber(buffer, block * kBlockRows + row + 1);
+                buffer += ';';
+                buffer += _models[modelIds[row]];
+                buffer += ';';
+                AppendNumber(buffer, years[row]);
+                buffer += ';';
+                AppendCents(buffer, prices[row]);
+                buffer += sold[row] ? ";1;" : ";0;";
+                AppendCents(buffer, salePrices[row]);
+                buffer += '\n';
+            }
+        },
+        [&](const std::string &buffer)
+        { out.write(buffer.data(), buffer.size()); });
+
+    out.close();
+    return static_cast<bool>(out);
+}
+
+bool SyntheticInventory::WriteSnapshot(const std::string &filename) const
+{
+    if (_options.rows >= 0xffffffffull)
+    {
+        return false; // car IDs are 32-bit
+    }
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+    {
+        return false;
+    }
+
+    std::string modelPool;
+    std::vector<std::uint64_t> modelStarts(1, 0);
+    for (const std::string &model : _models)
+    {
+        modelPool += model;
+        modelStarts.push_back(modelPool.size());
+    }
+
+    Snapshot::Header header = {};
+    std::memcpy(header.magic, Snapshot::kMagic, sizeof(header.magic));
+    header.version = Snapshot::kVersion;
+    header.nextCarId = static_cast<std::uint32_t>(_options.rows + 1);
+    header.recordCount = _options.rows;
+    header.modelCount = _models.size();
+    header.stringTableSize = modelPool.size();
+
+    // Header first as a placeholder; the checksum is only known at the end.
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    // Every block of a column is a multiple of 8 bytes except the last one,
+    // which gets the zero padding of the whole section.
+    Snapshot::Checksum checksum;
+    auto write = [&](std::string &buffer)
+    {
+        buffer.resize(Snapshot::Padded(buffer.size()), '\0');
+        checksum.Update(buffer.data(), buffer.size());
+        out.write(buffer.data(), buffer.size());
+    };
+    auto writeSection = [&](auto column)
+    {
+        ForEachBlock(column, write);
+    };
+
+    writeSection([&](std::uint64_t block, std::string &buffer)
+                 {
+                     std::vector<std::uint32_t> ids(BlockRows(block));
+                     for (std::size_t row = 0; row < ids.size(); row++)
+                     {
+                         ids[row] = static_cast<std::uint32_t>(block * kBlockRows + row + 1);
+                     }
+                     AppendColumn(buffer, ids); });
+    writeSection([&](std::uint64_t block, std::string &buffer)
+                 {
+                     std::vector<std::uint32_t> years(BlockRows(block));
+                     RegisterYears(block, years.data());
+                     AppendColumn(buffer, years); });
+    writeSection([&](std::uint64_t block, std::string &buffer)
+                 {
+                     std::vector<std::uint64_t> cents(BlockRows(block));
+                     InitialPrices(block, cents.data());
+                     std::vector<double> prices(cents.begin(), cents.end());
+                     for (double &price : prices)
+                     {
+                         price /= 100.0;
+                     }
+                     AppendColumn(buffer, prices); });
+    writeSection([&](std::uint64_t block, std::string &buffer)
+                 {
+                     std::vector<std::int64_t> addTimes(BlockRows(block), _options.addTime.time_since_epoch().count());
+                     AppendColumn(buffer, addTimes); });
+    writeSection([&](std::uint64_t block, std::string &buffer)
+                 {
+                     std::vector<std::uint64_t> initialCents(BlockRows(block));
+                     std::vector<std::uint8_t> soldFlags(BlockRows(block));
+                     std::vector<std::uint64_t> cents(BlockRows(block));
+                     InitialPrices(block, initialCents.data());
+                     SoldFlags(block, soldFlags.data());
+                     SalePrices(block, initialCents.data(), soldFlags.data(), cents.data());
+                     std::vector<double> prices(cents.begin(), cents.end());
+                     for (double &price : prices)
+                     {
+                         price /= 100.0;
+                     }
+                     AppendColumn(buffer, prices); });
+    writeSection([&](std::uint64_t block, std::string &buffer)
+                 {
+                     std::vector<std::uint8_t> soldFlags(BlockRows(block));
+                     SoldFlags(block, soldFlags.data());
+                     AppendColumn(buffer, soldFlags); });
+    writeSection([&](std::uint64_t block, std::string &buffer)
+                 {
+                     std::vector<std::uint32_t> modelIds(BlockRows(block));
+                     ModelIds(block, modelIds.data());
+                     AppendColumn(buffer, modelIds); });
+
+    std::string starts(reinterpret_cast<const char *>(modelStarts.data()), modelStarts.size() * sizeof(std::uint64_t));
+    write(starts);
+    write(modelPool);
+
+    header.payloadSize = static_cast<std::uint64_t>(out.tellp()) - sizeof(header);
+    header.checksum = checksum.Value();
+    out.seekp(0);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    out.close();
+    return static_cast<bool>(out);
+}
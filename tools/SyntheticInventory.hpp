@@ -0,0 +1,98 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Settings for a generated inventory.
+ */
+struct InventoryOptions
+{
+    std::uint64_t rows = 1000;
+    std::uint64_t seed = 1;
+    std::uint32_t modelCount = 2000; ///< Distinct model names.
+    double zipfExponent = 1.0;       ///< How much the popular models dominate; 0 makes all equally common.
+    unsigned int minYear = 2000;
+    unsigned int maxYear = 2024;
+    unsigned int minPrice = 10000; ///< Initial prices are whole amounts in [minPrice, maxPrice].
+    unsigned int maxPrice = 250000;
+    double soldRatio = 0.3;        ///< Share of cars that are already sold.
+    unsigned int threads = 0;      ///< 0 uses every core.
+
+    /// Add time written to snapshots (CSV files have none); the default is the moment of writing.
+    std::chrono::system_clock::time_point addTime;
+};
+
+/**
+ * @brief A large, made-up car inventory for load tests.
+ *
+ * Nothing is kept in memory: every value is computed from the seed, the
+ * row number and the column, so any piece of any column can be made on its
+ * own, in any order, on any thread, and always comes out the same. Rows are
+ * made in blocks of kBlockRows; every block and column has its own random
+ * stream, so the output does not depend on the number of threads, and a
+ * CSV file and a snapshot with the same options hold the same cars.
+ *
+ * Model names follow a Zipf distribution: the model with rank k shows up
+ * about 1 / k^zipfExponent as often as the most popular one, like in a real
+ * lot with a few best sellers and a long tail.
+ *
+ * Files are written block by block: worker threads fill the next blocks
+ * while the current ones are being written, in order. At most two blocks
+ * per thread are held in memory at once.
+ */
+class SyntheticInventory
+{
+
+private:
+    InventoryOptions _options;
+    std::vector<std::string> _models;
+    std::vector<double> _modelCdf; // per rank: chance of drawing this rank or a more popular one
+
+    unsigned int Threads() const;
+
+    // Calls fill(block, buffer) for every block on the worker threads and
+    // write(buffer) for every block in order on the calling thread.
+    template <typename Fill, typename Write>
+    void ForEachBlock(Fill fill, Write write) const;
+
+public:
+    static constexpr std::size_t kBlockRows = 65536;
+
+    explicit SyntheticInventory(const InventoryOptions &options);
+
+    const InventoryOptions &Options() const { return _options; }
+
+    /// The model names; the index is the model's popularity rank.
+    const std::vector<std::string> &Models() const { return _models; }
+
+    std::uint64_t BlockCount() const { return (_options.rows + kBlockRows - 1) / kBlockRows; }
+    std::size_t BlockRows(std::uint64_t block) const;
+
+    // Columns of one block; every array must hold BlockRows(block) values.
+    // Prices are in cents, so they print exactly with two decimals.
+    void ModelIds(std::uint64_t block, std::uint32_t *modelIds) const;
+    void RegisterYears(std::uint64_t block, std::uint32_t *years) const;
+    void InitialPrices(std::uint64_t block, std::uint64_t *cents) const;
+    void SoldFlags(std::uint64_t block, std::uint8_t *soldFlags) const;
+    /// Made from the block's InitialPrices and SoldFlags, which the caller already has; 0 for cars that are not sold.
+    void SalePrices(std::uint64_t block, const std::uint64_t *initialCents, const std::uint8_t *soldFlags,
+                    std::uint64_t *cents) const;
+
+    /**
+     * @brief Writes the inventory in the CarsDB text format.
+     *
+     * @return false if the file could not be written.
+     */
+    bool WriteCsv(const std::string &filename) const;
+
+    /**
+     * @brief Writes the inventory as a snapshot that CarManager::LoadSnapshot reads.
+     *
+     * @return false if the file could not be written or has too many rows for 32-bit IDs.
+     */
+    bool WriteSnapshot(const std::string &filename) const;
+};
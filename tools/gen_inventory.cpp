@@ -0,0 +1,127 @@
+// tools/gen_inventory.cpp
+//
+// Writes a synthetic car inventory of any size, for load tests:
+//
+//   gen_inventory --rows 100000000 --out CarsDB.csv
+//   gen_inventory --rows 1000000 --format snapshot --out CarsDB.snap --seed 7
+
+#include "SyntheticInventory.hpp"
+#include <charconv>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    void PrintUsage()
+    {
+        std::cout << "Usage: gen_inventory --rows N --out FILE [options]\n"
+                  << "  --format csv|snapshot   output format (default: csv)\n"
+                  << "  --seed N                random seed; the same seed gives the same cars (default: 1)\n"
+                  << "  --models N              distinct model names (default: 2000)\n"
+                  << "  --zipf S                Zipf exponent of the model popularity (default: 1.0)\n"
+                  << "  --years MIN-MAX         register years (default: 2000-2024)\n"
+                  << "  --prices MIN-MAX        initial prices (default: 10000-250000)\n"
+                  << "  --sold R                share of sold cars, 0..1 (default: 0.3)\n"
+                  << "  --threads N             worker threads, 0 for all cores (default: 0)\n";
+    }
+
+    template <typename T>
+    bool ParseValue(std::string_view text, T &value)
+    {
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+
+    bool ParseRange(std::string_view text, unsigned int &low, unsigned int &high)
+    {
+        std::size_t dash = text.find('-');
+        return dash != std::string_view::npos && ParseValue(text.substr(0, dash), low) &&
+               ParseValue(text.substr(dash + 1), high) && low <= high;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    InventoryOptions options;
+    std::string output;
+    std::string format = "csv";
+    bool rowsGiven = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string_view option = argv[i];
+        if (option == "--help" || option == "-h")
+        {
+            PrintUsage();
+            return 0;
+        }
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Error: " << option << " needs a value.\n";
+            return 1;
+        }
+
+        std::string_view value = argv[++i];
+        bool valid = true;
+        if (option == "--rows")
+        {
+            valid = ParseValue(value, options.rows);
+            rowsGiven = true;
+        }
+        else if (option == "--out")
+            output = value;
+        else if (option == "--format")
+        {
+            format = value;
+            valid = format == "csv" || format == "snapshot";
+        }
+        else if (option == "--seed")
+            valid = ParseValue(value, options.seed);
+        else if (option == "--models")
+            valid = ParseValue(value, options.modelCount) && options.modelCount > 0;
+        else if (option == "--zipf")
+            valid = ParseValue(value, options.zipfExponent) && options.zipfExponent >= 0.0;
+        else if (option == "--years")
+            valid = ParseRange(value, options.minYear, options.maxYear);
+        else if (option == "--prices")
+            valid = ParseRange(value, options.minPrice, options.maxPrice);
+        else if (option == "--sold")
+            valid = ParseValue(value, options.soldRatio) && options.soldRatio >= 0.0 && options.soldRatio <= 1.0;
+        else if (option == "--threads")
+            valid = ParseValue(value, options.threads);
+        else
+        {
+            std::cerr << "Error: Unknown option " << option << ".\n";
+            PrintUsage();
+            return 1;
+        }
+
+        if (!valid)
+        {
+            std::cerr << "Error: Invalid value for " << option << ": " << value << ".\n";
+            return 1;
+        }
+    }
+
+    if (!rowsGiven || output.empty())
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    SyntheticInventory inventory(options);
+    bool written = format == "csv" ? inventory.WriteCsv(output) : inventory.WriteSnapshot(output);
+
+    if (!written)
+    {
+        std::cerr << "Error: Could not write " << output << ".\n";
+        return 1;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Wrote " << options.rows << " cars to " << output << " in " << elapsed.count() << " s.\n";
+    return 0;
+}